@@ -0,0 +1,347 @@
+#ifndef BSRSPARSEMATRIX_H
+#define BSRSPARSEMATRIX_H
+
+#include "SparseMatrix.h"
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <tuple>
+
+// Блочний CSR: зберігаються щільні блоки B x B (по рядках усередині блока),
+// один індекс стовпця на блок. Розмір блока відомий під час компіляції, тому
+// цикли по B у ядрах розгортаються компілятором. Позиції блока без значення
+// заповнюються defaultValue
+template<typename T, size_t B>
+class BSRSparseMatrix : public SparseMatrix<T> {
+private:
+    static_assert(B > 0, "Block size must be positive");
+    
+    std::vector<T> blockValues;
+    std::vector<size_t> blockColIndices;
+    std::vector<size_t> blockRowPointers;
+    
+    using SparseMatrix<T>::rows;
+    using SparseMatrix<T>::cols;
+    using SparseMatrix<T>::defaultValue;
+    
+    size_t blockRows() const { return (rows + B - 1) / B; }
+    size_t blockCols() const { return (cols + B - 1) / B; }
+    
+    static BSRSparseMatrix<T, B> convert(const SparseMatrix<T>& other) {
+        const CSRSparseMatrix<T>* csr = dynamic_cast<const CSRSparseMatrix<T>*>(&other);
+        if (csr) return fromCSR(*csr);
+        
+        const MapSparseMatrix<T>* map = dynamic_cast<const MapSparseMatrix<T>*>(&other);
+        if (map) return fromCSR(map->toCSR());
+        
+        std::vector<std::tuple<size_t, size_t, T>> triplets;
+        other.forEachNonZero([&](size_t i, size_t j, const T& value) {
+            triplets.emplace_back(i, j, value);
+        });
+        return fromCSR(CSRSparseMatrix<T>::fromTriplets(other.getRows(), other.getCols(),
+                                                        std::move(triplets), other.getDefaultValue()));
+    }
+    
+    // sums[r] += блок[r][c] * xs[c] для перших width стовпців блоку
+    static void accumulateBlock(const T* block, const T* xs, size_t width, T* sums) {
+        for (size_t r = 0; r < B; ++r) {
+            T sum = sums[r];
+            for (size_t c = 0; c < width; ++c) {
+                sum = sum + block[r * B + c] * xs[c];
+            }
+            sums[r] = sum;
+        }
+    }
+    
+public:
+    
+    BSRSparseMatrix(size_t r = 0, size_t c = 0, const T& defVal = T())
+        : SparseMatrix<T>(r, c, defVal) {
+        blockRowPointers.resize(blockRows() + 1, 0);
+    }
+    
+    static BSRSparseMatrix<T, B> fromCSR(const CSRSparseMatrix<T>& csr) {
+        BSRSparseMatrix<T, B> result(csr.getRows(), csr.getCols(), csr.getDefaultValue());
+        const std::vector<size_t>& rowPointers = csr.getRowPointers();
+        const std::vector<size_t>& colIndices = csr.getColIndices();
+        const std::vector<T>& values = csr.getValues();
+        
+        const size_t unmarked = std::numeric_limits<size_t>::max();
+        std::vector<size_t> slot(result.blockCols(), unmarked);
+        std::vector<size_t> touched;
+        
+        for (size_t br = 0; br < result.blockRows(); ++br) {
+            size_t rowBegin = br * B;
+            size_t rowEnd = std::min(result.rows, rowBegin + B);
+            
+            touched.clear();
+            for (size_t i = rowBegin; i < rowEnd; ++i) {
+                for (size_t j = rowPointers[i]; j < rowPointers[i + 1]; ++j) {
+                    size_t bc = colIndices[j] / B;
+                    if (slot[bc] == unmarked) {
+                        slot[bc] = 0;
+                        touched.push_back(bc);
+                    }
+                }
+            }
+            std::sort(touched.begin(), touched.end());
+            
+            size_t first = result.blockColIndices.size();
+            for (size_t k = 0; k < touched.size(); ++k) {
+                slot[touched[k]] = first + k;
+                result.blockColIndices.push_back(touched[k]);
+            }
+            result.blockValues.resize((first + touched.size()) * B * B, result.defaultValue);
+            
+            for (size_t i = rowBegin; i < rowEnd; ++i) {
+                for (size_t j = rowPointers[i]; j < rowPointers[i + 1]; ++j) {
+                    size_t block = slot[colIndices[j] / B];
+                    result.blockValues[block * B * B + (i - rowBegin) * B + colIndices[j] % B] = values[j];
+                }
+            }
+            for (size_t bc : touched) slot[bc] = unmarked;
+            result.blockRowPointers[br + 1] = result.blockColIndices.size();
+        }
+        
+        return result;
+    }
+    
+    // Блоки рядка блоків упорядковані за стовпцем, тож обхід рядок за рядком через
+    // усі блоки дає стовпці за зростанням
+    void forEachNonZero(const std::function<void(size_t, size_t, const T&)>& visit) const override {
+        for (size_t br = 0; br < blockRows(); ++br) {
+            for (size_t r = 0; r < B && br * B + r < rows; ++r) {
+                for (size_t k = blockRowPointers[br]; k < blockRowPointers[br + 1]; ++k) {
+                    const T* block = blockValues.data() + k * B * B;
+                    for (size_t c = 0; c < B && blockColIndices[k] * B + c < cols; ++c) {
+                        if (block[r * B + c] != defaultValue) {
+                            visit(br * B + r, blockColIndices[k] * B + c, block[r * B + c]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    
+    CSRSparseMatrix<T> toCSR() const {
+        std::vector<size_t> rowPointers(rows + 1, 0);
+        std::vector<size_t> colIndices;
+        std::vector<T> values;
+        
+        forEachNonZero([&](size_t i, size_t j, const T& value) {
+            colIndices.push_back(j);
+            values.push_back(value);
+            ++rowPointers[i + 1];
+        });
+        for (size_t i = 0; i < rows; ++i) {
+            rowPointers[i + 1] += rowPointers[i];
+        }
+        
+        return CSRSparseMatrix<T>::fromArrays(rows, cols, std::move(rowPointers),
+                                              std::move(colIndices), std::move(values), defaultValue);
+    }
+    
+    size_t blockCount() const {
+        return blockColIndices.size();
+    }
+    
+    T get(size_t row, size_t col) const override {
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("Matrix index out of range");
+        }
+        
+        size_t br = row / B, bc = col / B;
+        auto first = blockColIndices.begin() + blockRowPointers[br];
+        auto last = blockColIndices.begin() + blockRowPointers[br + 1];
+        auto it = std::lower_bound(first, last, bc);
+        if (it == last || *it != bc) return defaultValue;
+        size_t block = static_cast<size_t>(it - blockColIndices.begin());
+        return blockValues[block * B * B + (row % B) * B + col % B];
+    }
+    
+    void set(size_t, size_t, const T&) override {
+        throw std::runtime_error("BSR set not implemented - use for read-only operations");
+    }
+    
+    size_t nonZeroCount() const override {
+        size_t count = 0;
+        for (const T& value : blockValues) {
+            if (value != defaultValue) ++count;
+        }
+        return count;
+    }
+    
+    std::string toString() const override {
+        std::ostringstream oss;
+        oss << "BSRSparseMatrix[" << rows << "x" << cols << ", block=" << B << "x" << B
+            << ", blocks=" << blockColIndices.size() << "]";
+        return oss.str();
+    }
+    
+    void clear() override {
+        blockValues.clear();
+        blockColIndices.clear();
+        blockRowPointers.assign(blockRows() + 1, 0);
+    }
+    
+    SparseMatrix<T>* add(const SparseMatrix<T>& other) const override {
+        if (rows != other.getRows() || cols != other.getCols()) {
+            throw std::invalid_argument("Matrix dimensions must match for addition");
+        }
+        
+        const BSRSparseMatrix<T, B>* bsr = dynamic_cast<const BSRSparseMatrix<T, B>*>(&other);
+        BSRSparseMatrix<T, B> converted;
+        if (!bsr) {
+            converted = convert(other);
+            bsr = &converted;
+        }
+        const BSRSparseMatrix<T, B>& rhs = *bsr;
+        
+        BSRSparseMatrix<T, B>* result = new BSRSparseMatrix<T, B>(rows, cols, defaultValue);
+        for (size_t br = 0; br < blockRows(); ++br) {
+            size_t a = blockRowPointers[br], aEnd = blockRowPointers[br + 1];
+            size_t b = rhs.blockRowPointers[br], bEnd = rhs.blockRowPointers[br + 1];
+            
+            while (a < aEnd || b < bEnd) {
+                size_t bc;
+                bool takeA = b == bEnd || (a < aEnd && blockColIndices[a] <= rhs.blockColIndices[b]);
+                bool takeB = a == aEnd || (b < bEnd && rhs.blockColIndices[b] <= blockColIndices[a]);
+                bc = takeA ? blockColIndices[a] : rhs.blockColIndices[b];
+                
+                size_t offset = result->blockValues.size();
+                result->blockValues.resize(offset + B * B);
+                T* out = result->blockValues.data() + offset;
+                const T* left = takeA ? blockValues.data() + a * B * B : nullptr;
+                const T* right = takeB ? rhs.blockValues.data() + b * B * B : nullptr;
+                for (size_t k = 0; k < B * B; ++k) {
+                    out[k] = (left ? left[k] : defaultValue) + (right ? right[k] : rhs.defaultValue);
+                }
+                result->blockColIndices.push_back(bc);
+                
+                if (takeA) ++a;
+                if (takeB) ++b;
+            }
+            result->blockRowPointers[br + 1] = result->blockColIndices.size();
+        }
+        
+        return result;
+    }
+    
+    SparseMatrix<T>* multiply(const SparseMatrix<T>& other) const override {
+        std::unique_ptr<SparseMatrix<T>> product(toCSR().multiply(other));
+        return new BSRSparseMatrix<T, B>(fromCSR(static_cast<const CSRSparseMatrix<T>&>(*product)));
+    }
+    
+    std::vector<T> multiplyVector(const std::vector<T>& vec) const override {
+        std::vector<T> result;
+        multiplyVector(vec, result);
+        return result;
+    }
+    
+    // Результат пишеться в наданий вектор; останній неповний стовпець блоків
+    // обробляється за шириною, тож вхідний вектор не доповнюється копією
+    void multiplyVector(const std::vector<T>& vec, std::vector<T>& result) const override {
+        if (cols != vec.size()) {
+            throw std::invalid_argument("Vector size must match matrix columns");
+        }
+        if (&vec == &result) {
+            throw std::invalid_argument("Result vector must not alias the input");
+        }
+        
+        result.resize(rows);
+        for (size_t br = 0; br < blockRows(); ++br) {
+            T sums[B];
+            for (size_t r = 0; r < B; ++r) sums[r] = defaultValue;
+            
+            for (size_t k = blockRowPointers[br]; k < blockRowPointers[br + 1]; ++k) {
+                const T* block = blockValues.data() + k * B * B;
+                size_t firstCol = blockColIndices[k] * B;
+                if (firstCol + B <= cols) {
+                    accumulateBlock(block, vec.data() + firstCol, B, sums);
+                } else {
+                    accumulateBlock(block, vec.data() + firstCol, cols - firstCol, sums);
+                }
+            }
+            
+            for (size_t r = 0; r < B && br * B + r < rows; ++r) {
+                result[br * B + r] = sums[r];
+            }
+        }
+    }
+    
+    SparseMatrix<T>* transpose() const override {
+        BSRSparseMatrix<T, B>* result = new BSRSparseMatrix<T, B>(cols, rows, defaultValue);
+        result->blockValues.resize(blockValues.size());
+        result->blockColIndices.resize(blockColIndices.size());
+        
+        for (size_t bc : blockColIndices) {
+            ++result->blockRowPointers[bc + 1];
+        }
+        for (size_t bc = 0; bc < blockCols(); ++bc) {
+            result->blockRowPointers[bc + 1] += result->blockRowPointers[bc];
+        }
+        
+        std::vector<size_t> next(result->blockRowPointers.begin(), result->blockRowPointers.end() - 1);
+        for (size_t br = 0; br < blockRows(); ++br) {
+            for (size_t k = blockRowPointers[br]; k < blockRowPointers[br + 1]; ++k) {
+                size_t pos = next[blockColIndices[k]]++;
+                result->blockColIndices[pos] = br;
+                const T* in = blockValues.data() + k * B * B;
+                T* out = result->blockValues.data() + pos * B * B;
+                for (size_t r = 0; r < B; ++r) {
+                    for (size_t c = 0; c < B; ++c) {
+                        out[c * B + r] = in[r * B + c];
+                    }
+                }
+            }
+        }
+        
+        return result;
+    }
+    
+    void saveToFile(const std::string& filename) const override {
+        std::ofstream out(filename);
+        if (!out) throw std::runtime_error("Cannot open file for writing");
+        
+        out << "BSRSparseMatrix\n";
+        out << rows << " " << cols << " " << B << "\n";
+        out << blockColIndices.size() << "\n";
+        
+        for (const auto& v : blockValues) out << v << " ";
+        out << "\n";
+        for (const auto& c : blockColIndices) out << c << " ";
+        out << "\n";
+        for (const auto& r : blockRowPointers) out << r << " ";
+        out << "\n";
+    }
+    
+    void loadFromFile(const std::string& filename) override {
+        std::ifstream in(filename);
+        if (!in) throw std::runtime_error("Cannot open file for reading");
+        
+        std::string type;
+        in >> type;
+        if (type != "BSRSparseMatrix") throw std::runtime_error("Invalid file format");
+        
+        size_t r, c, blockSize, count;
+        in >> r >> c >> blockSize >> count;
+        if (blockSize != B) throw std::runtime_error("Block size in file does not match");
+        
+        rows = r;
+        cols = c;
+        
+        blockValues.resize(count * B * B);
+        blockColIndices.resize(count);
+        blockRowPointers.resize(blockRows() + 1);
+        
+        for (auto& v : blockValues) in >> v;
+        for (auto& idx : blockColIndices) in >> idx;
+        for (auto& ptr : blockRowPointers) in >> ptr;
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,239 @@
+#ifndef COMPRESSEDCSRMATRIX_H
+#define COMPRESSEDCSRMATRIX_H
+
+#include "SparseMatrix.h"
+#include "ThreadPool.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+
+// CSR зі стиснутими індексами стовпців. Перший стовпець рядка пишеться бітами
+// фіксованої для матриці ширини, далі — різниці між сусідніми стовпцями мінус один,
+// упаковані однаковою для рядка кількістю біт (за найбільшою різницею в рядку).
+// Для графів із локальною нумерацією різниця займає кілька біт замість 64 чи 32.
+// Індекси розпаковуються прямо в multiplyVector без розгалужень: одне читання
+// 64-бітного слова, зсув і маска на елемент. Потік біт читається як little-endian.
+// Формат лише для читання; значення і rowPointers зберігаються як у звичайному CSR
+template<typename T, typename Index = size_t>
+class CompressedCSRMatrix {
+private:
+    size_t rows, cols;
+    T defaultValue;
+    std::vector<T> values;
+    std::vector<Index> rowPointers;
+    std::vector<size_t> bitOffsets;
+    std::vector<uint8_t> rowWidths;
+    std::vector<uint8_t> columnBits;
+    unsigned firstWidth = 0;
+    
+    // Ширина обмежена 57 бітами, щоб зсув у межах байта вміщувався в одне слово
+    static const unsigned maxWidth = 57;
+    
+    static unsigned bitWidth(uint64_t value) {
+        unsigned width = 0;
+        for (; value; value >>= 1) ++width;
+        return width;
+    }
+    
+    static uint64_t readBits(const uint8_t* data, size_t position, unsigned width) {
+        uint64_t word;
+        std::memcpy(&word, data + (position >> 3), sizeof(word));
+        return (word >> (position & 7)) & ((uint64_t(1) << width) - 1);
+    }
+    
+    static void writeBits(uint8_t* data, size_t position, uint64_t value) {
+        uint64_t word;
+        std::memcpy(&word, data + (position >> 3), sizeof(word));
+        word |= value << (position & 7);
+        std::memcpy(data + (position >> 3), &word, sizeof(word));
+    }
+    
+    T rowDot(size_t row, const std::vector<T>& vec) const {
+        size_t begin = rowPointers[row], end = rowPointers[row + 1];
+        T sum = defaultValue;
+        if (begin == end) return sum;
+        
+        const uint8_t* data = columnBits.data();
+        size_t position = bitOffsets[row];
+        unsigned width = rowWidths[row];
+        size_t col = readBits(data, position, firstWidth);
+        position += firstWidth;
+        sum = sum + values[begin] * vec[col];
+        for (size_t j = begin + 1; j < end; ++j) {
+            col += readBits(data, position, width) + 1;
+            position += width;
+            sum = sum + values[j] * vec[col];
+        }
+        return sum;
+    }
+    
+    // Стовпці рядка по черзі передаються у visit(позиція в values, стовпець)
+    template<typename Visitor>
+    void decodeRow(size_t row, Visitor&& visit) const {
+        size_t begin = rowPointers[row], end = rowPointers[row + 1];
+        if (begin == end) return;
+        
+        size_t position = bitOffsets[row];
+        size_t col = readBits(columnBits.data(), position, firstWidth);
+        position += firstWidth;
+        if (!visit(begin, col)) return;
+        for (size_t j = begin + 1; j < end; ++j) {
+            col += readBits(columnBits.data(), position, rowWidths[row]) + 1;
+            position += rowWidths[row];
+            if (!visit(j, col)) return;
+        }
+    }
+    
+    // Межі parts діапазонів рядків із приблизно однаковою кількістю ненульових елементів
+    std::vector<size_t> partitionRows(size_t parts) const {
+        parts = std::max<size_t>(1, std::min(parts, std::max<size_t>(rows, 1)));
+        std::vector<size_t> bounds(parts + 1, rows);
+        bounds[0] = 0;
+        for (size_t p = 1; p < parts; ++p) {
+            size_t target = values.size() * p / parts;
+            size_t row = std::lower_bound(rowPointers.begin(), rowPointers.end(), target) - rowPointers.begin();
+            bounds[p] = std::max(bounds[p - 1], std::min(row, rows));
+        }
+        return bounds;
+    }
+    
+public:
+    // Два проходи: спершу ширини й бітові зміщення рядків, потім запис у виділений потік
+    template<typename SourceIndex>
+    explicit CompressedCSRMatrix(const CSRSparseMatrix<T, SourceIndex>& csr)
+        : rows(csr.getRows()), cols(csr.getCols()), defaultValue(csr.getDefaultValue()),
+          values(csr.getValues()), bitOffsets(csr.getRows() + 1, 0), rowWidths(csr.getRows(), 0) {
+        const std::vector<SourceIndex>& csrRows = csr.getRowPointers();
+        const std::vector<SourceIndex>& csrCols = csr.getColIndices();
+        if (values.size() > static_cast<size_t>(std::numeric_limits<Index>::max())) {
+            throw std::overflow_error("Matrix is too large for the CSR index type");
+        }
+        firstWidth = bitWidth(cols > 0 ? cols - 1 : 0);
+        if (firstWidth > maxWidth) {
+            throw std::overflow_error("Matrix is too large for the compressed index format");
+        }
+        rowPointers.assign(csrRows.begin(), csrRows.end());
+        
+        // Різниці кодуються без знаку, тож стовпці рядка мають строго зростати
+        for (size_t i = 0; i < rows; ++i) {
+            size_t begin = csrRows[i], end = csrRows[i + 1];
+            for (size_t j = begin; j < end; ++j) {
+                if (static_cast<size_t>(csrCols[j]) >= cols || (j > begin && csrCols[j] <= csrCols[j - 1])) {
+                    throw std::invalid_argument("Column indices must be increasing within each row");
+                }
+            }
+        }
+        
+        for (size_t i = 0; i < rows; ++i) {
+            size_t begin = csrRows[i], end = csrRows[i + 1];
+            unsigned width = 0;
+            for (size_t j = begin + 1; j < end; ++j) {
+                width = std::max(width, bitWidth(static_cast<uint64_t>(csrCols[j] - csrCols[j - 1] - 1)));
+            }
+            rowWidths[i] = static_cast<uint8_t>(width);
+            size_t bits = begin == end ? 0 : firstWidth + width * (end - begin - 1);
+            bitOffsets[i + 1] = bitOffsets[i] + bits;
+        }
+        
+        // Запас у 8 байтів дозволяє читати повне слово біля кінця потоку
+        columnBits.assign((bitOffsets[rows] + 7) / 8 + sizeof(uint64_t), 0);
+        for (size_t i = 0; i < rows; ++i) {
+            size_t begin = csrRows[i], end = csrRows[i + 1];
+            if (begin == end) continue;
+            size_t position = bitOffsets[i];
+            writeBits(columnBits.data(), position, csrCols[begin]);
+            position += firstWidth;
+            for (size_t j = begin + 1; j < end; ++j) {
+                writeBits(columnBits.data(), position, static_cast<uint64_t>(csrCols[j] - csrCols[j - 1] - 1));
+                position += rowWidths[i];
+            }
+        }
+    }
+    
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+    const T& getDefaultValue() const { return defaultValue; }
+    size_t nonZeroCount() const { return values.size(); }
+    
+    // Байти, зайняті індексами: потік біт, зміщення й ширини рядків і rowPointers
+    size_t indexBytes() const {
+        return columnBits.size() + bitOffsets.size() * sizeof(size_t) + rowWidths.size()
+             + rowPointers.size() * sizeof(Index);
+    }
+    
+    T get(size_t row, size_t col) const {
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("Matrix index out of range");
+        }
+        
+        T result = defaultValue;
+        decodeRow(row, [&](size_t j, size_t current) {
+            if (current == col) result = values[j];
+            return current < col;
+        });
+        return result;
+    }
+    
+    void multiplyVector(const std::vector<T>& vec, std::vector<T>& result) const {
+        if (cols != vec.size()) {
+            throw std::invalid_argument("Vector size must match matrix columns");
+        }
+        if (&vec == &result) {
+            throw std::invalid_argument("Result vector must not alias the input");
+        }
+        
+        result.resize(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            result[i] = rowDot(i, vec);
+        }
+    }
+    
+    std::vector<T> multiplyVector(const std::vector<T>& vec) const {
+        std::vector<T> result;
+        multiplyVector(vec, result);
+        return result;
+    }
+    
+    std::vector<T> multiplyVectorParallel(const std::vector<T>& vec,
+                                          ThreadPool& pool = ThreadPool::shared()) const {
+        if (cols != vec.size()) {
+            throw std::invalid_argument("Vector size must match matrix columns");
+        }
+        
+        std::vector<T> result(rows, defaultValue);
+        std::vector<size_t> bounds = partitionRows(pool.size());
+        pool.parallelFor(bounds.size() - 1, [&](size_t p) {
+            for (size_t i = bounds[p]; i < bounds[p + 1]; ++i) {
+                result[i] = rowDot(i, vec);
+            }
+        });
+        
+        return result;
+    }
+    
+    CSRSparseMatrix<T, Index> toCSR() const {
+        std::vector<Index> colIndices;
+        colIndices.reserve(values.size());
+        for (size_t i = 0; i < rows; ++i) {
+            decodeRow(i, [&](size_t, size_t col) {
+                colIndices.push_back(static_cast<Index>(col));
+                return true;
+            });
+        }
+        return CSRSparseMatrix<T, Index>::fromArrays(rows, cols, rowPointers, std::move(colIndices),
+                                                     values, defaultValue);
+    }
+    
+    std::string toString() const {
+        std::ostringstream oss;
+        oss << "CompressedCSRMatrix[" << rows << "x" << cols << ", stored=" << values.size()
+            << ", index bytes=" << indexBytes() << "]";
+        return oss.str();
+    }
+};
+
+#endif
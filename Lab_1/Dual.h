@@ -0,0 +1,57 @@
+#ifndef DUAL_H
+#define DUAL_H
+
+#include <cmath>
+
+// Дуальне число value + derivative * e, e^2 = 0: арифметика над ним переносить
+// похідну за ланцюговим правилом, тож одне обчислення дає f(x) і f'(x)
+struct Dual {
+    double value;
+    double derivative;
+    
+    Dual(double v = 0.0, double d = 0.0) : value(v), derivative(d) {}
+};
+
+inline Dual operator+(const Dual& a, const Dual& b) {
+    return Dual(a.value + b.value, a.derivative + b.derivative);
+}
+
+inline Dual operator+(const Dual& a, double b) {
+    return Dual(a.value + b, a.derivative);
+}
+
+inline Dual operator*(const Dual& a, const Dual& b) {
+    return Dual(a.value * b.value, a.derivative * b.value + a.value * b.derivative);
+}
+
+inline Dual operator*(const Dual& a, double b) {
+    return Dual(a.value * b, a.derivative * b);
+}
+
+inline Dual operator/(double a, const Dual& b) {
+    double inverse = a / b.value;
+    return Dual(inverse, -inverse * b.derivative / b.value);
+}
+
+inline Dual pow(const Dual& a, double exponent) {
+    return Dual(std::pow(a.value, exponent), exponent * std::pow(a.value, exponent - 1.0) * a.derivative);
+}
+
+inline Dual sin(const Dual& a) {
+    return Dual(std::sin(a.value), std::cos(a.value) * a.derivative);
+}
+
+inline Dual cos(const Dual& a) {
+    return Dual(std::cos(a.value), -std::sin(a.value) * a.derivative);
+}
+
+inline Dual exp(const Dual& a) {
+    double value = std::exp(a.value);
+    return Dual(value, value * a.derivative);
+}
+
+inline Dual log(const Dual& a) {
+    return Dual(std::log(a.value), a.derivative / a.value);
+}
+
+#endif
@@ -0,0 +1,440 @@
+#ifndef EXPRESSIONPROGRAM_H
+#define EXPRESSIONPROGRAM_H
+
+#include "Dual.h"
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+enum class OpCode : uint8_t {
+    Const,       // value
+    LoadX,       // x
+    Add,         // r[a] + r[b]
+    Mul,         // r[a] * r[b]
+    AddConst,    // r[a] + value
+    MulConst,    // r[a] * value
+    Square,      // r[a] * r[a]
+    Reciprocal,  // 1 / r[a]
+    Pow,         // pow(r[a], value)
+    Sin,
+    Cos,
+    Exp,
+    Ln
+};
+
+// Плоска програма обчислення виразу: інструкція i пише результат у регістр i
+// і читає лише регістри з меншими номерами, тож дерево вузлів з віртуальними
+// викликами перетворюється на один прохід по масиву з switch.
+// Під час запису x завантажується один раз, константні операнди стають безпосередніми,
+// операції над константами згортаються, а цілі степені розкладаються на множення;
+// однакові інструкції (з точністю до порядку операндів add і mul) записуються один раз,
+// тож спільний підвираз обчислюється один раз на точку;
+// finish() прибирає інструкції, від яких результат не залежить
+class ExpressionProgram {
+public:
+    struct Instruction {
+        OpCode op;
+        uint32_t a;
+        uint32_t b;
+        double value;
+    };
+    
+private:
+    std::vector<Instruction> code;
+    uint32_t result = 0;
+    uint32_t variable = none;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> numbering;
+    
+    static constexpr uint32_t none = 0xFFFFFFFFu;
+    
+    // Регістри до цього розміру живуть на стеку, довші програми беруть буфер потоку
+    static const size_t inlineRegisters = 64;
+    
+    // Пакетне обчислення тримає регістровий файл блоку в межах 256 КБ
+    static constexpr size_t maxBlock = 256;
+    static constexpr size_t blockRegisterBudget = 32768;
+    
+    // Повертає регістр уже записаної такої самої інструкції, якщо вона є
+    uint32_t push(OpCode op, uint32_t a, uint32_t b, double value) {
+        if ((op == OpCode::Add || op == OpCode::Mul) && a > b) std::swap(a, b);
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        uint64_t hash = ((static_cast<uint64_t>(op) * 0x9E3779B97F4A7C15ull ^ a) * 0xBF58476D1CE4E5B9ull ^ b)
+                      * 0x94D049BB133111EBull ^ bits;
+        
+        std::vector<uint32_t>& candidates = numbering[hash];
+        for (uint32_t reg : candidates) {
+            const Instruction& in = code[reg];
+            if (in.op == op && in.a == a && in.b == b && std::memcmp(&in.value, &value, sizeof(value)) == 0) {
+                return reg;
+            }
+        }
+        code.push_back(Instruction{op, a, b, value});
+        candidates.push_back(static_cast<uint32_t>(code.size() - 1));
+        return static_cast<uint32_t>(code.size() - 1);
+    }
+    
+    bool isConstant(uint32_t reg) const {
+        return code[reg].op == OpCode::Const;
+    }
+    
+    static double apply(OpCode op, double a, double b, double value) {
+        switch (op) {
+            case OpCode::Add: return a + b;
+            case OpCode::Mul: return a * b;
+            case OpCode::AddConst: return a + value;
+            case OpCode::MulConst: return a * value;
+            case OpCode::Square: return a * a;
+            case OpCode::Reciprocal: return 1.0 / a;
+            case OpCode::Pow: return std::pow(a, value);
+            case OpCode::Sin: return std::sin(a);
+            case OpCode::Cos: return std::cos(a);
+            case OpCode::Exp: return std::exp(a);
+            case OpCode::Ln: return std::log(a);
+            default: return value;
+        }
+    }
+    
+    // base^n для цілого n > 0 двійковим піднесенням: O(log n) множень
+    uint32_t emitIntegerPower(uint32_t base, unsigned n) {
+        uint32_t result = none;
+        for (; n > 0; n >>= 1) {
+            if (n & 1) result = result == none ? base : emitBinary(OpCode::Mul, result, base);
+            if (n > 1) base = emitUnary(OpCode::Square, base);
+        }
+        return result;
+    }
+    
+public:
+    uint32_t emitConstant(double value) {
+        return push(OpCode::Const, 0, 0, value);
+    }
+    
+    uint32_t emitVariable() {
+        if (variable == none) variable = push(OpCode::LoadX, 0, 0, 0.0);
+        return variable;
+    }
+    
+    uint32_t emitUnary(OpCode op, uint32_t operand) {
+        if (isConstant(operand)) return emitConstant(apply(op, code[operand].value, 0.0, 0.0));
+        return push(op, operand, 0, 0.0);
+    }
+    
+    uint32_t emitBinary(OpCode op, uint32_t left, uint32_t right) {
+        if (isConstant(left) && isConstant(right)) {
+            return emitConstant(apply(op, code[left].value, code[right].value, 0.0));
+        }
+        if (isConstant(left)) std::swap(left, right);
+        if (isConstant(right)) {
+            OpCode immediate = op == OpCode::Add ? OpCode::AddConst : OpCode::MulConst;
+            return push(immediate, left, 0, code[right].value);
+        }
+        return push(op, left, right, 0.0);
+    }
+    
+    // Цілі степені до 8 за модулем розкладаються на множення, від'ємні — ще й на
+    // обернення. Похибка росте з кожним піднесенням до квадрата: для |n| <= 8 результат
+    // відрізняється від pow на кілька ulp, тож вищі степені лишаються за Pow
+    uint32_t emitPower(uint32_t base, double exponent) {
+        if (exponent == 0.0) return emitConstant(1.0);
+        if (isConstant(base)) return emitConstant(std::pow(code[base].value, exponent));
+        if (exponent == std::floor(exponent) && std::abs(exponent) <= 8.0) {
+            uint32_t power = emitIntegerPower(base, static_cast<unsigned>(std::abs(exponent)));
+            return exponent > 0 ? power : emitUnary(OpCode::Reciprocal, power);
+        }
+        return push(OpCode::Pow, base, 0, exponent);
+    }
+    
+    // Фіксує регістр результату і видаляє інструкції, недосяжні з нього
+    void finish(uint32_t reg) {
+        if (reg >= code.size()) throw std::out_of_range("Result register out of range");
+        
+        std::vector<char> live(code.size(), 0);
+        live[reg] = 1;
+        for (size_t i = reg + 1; i-- > 0;) {
+            if (!live[i]) continue;
+            switch (code[i].op) {
+                case OpCode::Const:
+                case OpCode::LoadX: break;
+                case OpCode::Add:
+                case OpCode::Mul: live[code[i].a] = live[code[i].b] = 1; break;
+                default: live[code[i].a] = 1; break;
+            }
+        }
+        
+        std::vector<uint32_t> renamed(code.size(), none);
+        std::vector<Instruction> compacted;
+        for (size_t i = 0; i <= reg; ++i) {
+            if (!live[i]) continue;
+            Instruction in = code[i];
+            in.a = renamed[in.a];
+            if (in.op == OpCode::Add || in.op == OpCode::Mul) in.b = renamed[in.b];
+            else in.b = 0;
+            if (in.op == OpCode::Const || in.op == OpCode::LoadX) in.a = 0;
+            renamed[i] = static_cast<uint32_t>(compacted.size());
+            compacted.push_back(in);
+        }
+        code.swap(compacted);
+        numbering.clear();
+        result = renamed[reg];
+        variable = none;
+        for (size_t i = 0; i < code.size(); ++i) {
+            if (code[i].op == OpCode::LoadX) variable = static_cast<uint32_t>(i);
+        }
+    }
+    
+    size_t size() const { return code.size(); }
+    bool empty() const { return code.empty(); }
+    const std::vector<Instruction>& instructions() const { return code; }
+    
+    // Виконання з наданим масивом щонайменше size() регістрів. Тип T — double або
+    // інший числовий тип з тими самими операціями (Dual для похідної)
+    template<typename T>
+    T run(const T& x, T* r) const {
+        using std::pow;
+        using std::sin;
+        using std::cos;
+        using std::exp;
+        using std::log;
+        const Instruction* ins = code.data();
+        for (size_t i = 0, n = code.size(); i < n; ++i) {
+            const Instruction& in = ins[i];
+            switch (in.op) {
+                case OpCode::Const: r[i] = T(in.value); break;
+                case OpCode::LoadX: r[i] = x; break;
+                case OpCode::Add: r[i] = r[in.a] + r[in.b]; break;
+                case OpCode::Mul: r[i] = r[in.a] * r[in.b]; break;
+                case OpCode::AddConst: r[i] = r[in.a] + in.value; break;
+                case OpCode::MulConst: r[i] = r[in.a] * in.value; break;
+                case OpCode::Square: r[i] = r[in.a] * r[in.a]; break;
+                case OpCode::Reciprocal: r[i] = 1.0 / r[in.a]; break;
+                case OpCode::Pow: r[i] = pow(r[in.a], in.value); break;
+                case OpCode::Sin: r[i] = sin(r[in.a]); break;
+                case OpCode::Cos: r[i] = cos(r[in.a]); break;
+                case OpCode::Exp: r[i] = exp(r[in.a]); break;
+                case OpCode::Ln: r[i] = log(r[in.a]); break;
+            }
+        }
+        return r[result];
+    }
+    
+    double evaluate(double x, double* r) const {
+        return run(x, r);
+    }
+    
+    double evaluate(double x) const {
+        if (code.empty()) throw std::logic_error("Expression program is empty");
+        if (code.size() <= inlineRegisters) {
+            double registers[inlineRegisters];
+            return evaluate(x, registers);
+        }
+        thread_local std::vector<double> registers;
+        if (registers.size() < code.size()) registers.resize(code.size());
+        return evaluate(x, registers.data());
+    }
+    
+    // f(x) і f'(x) за один прохід у дуальних числах (пряме автоматичне диференціювання)
+    double evaluateWithDerivative(double x, double& derivative) const {
+        if (code.empty()) throw std::logic_error("Expression program is empty");
+        Dual value;
+        if (code.size() <= inlineRegisters) {
+            Dual registers[inlineRegisters];
+            value = run(Dual(x, 1.0), registers);
+        } else {
+            thread_local std::vector<Dual> registers;
+            if (registers.size() < code.size()) registers.resize(code.size());
+            value = run(Dual(x, 1.0), registers.data());
+        }
+        derivative = value.derivative;
+        return value.value;
+    }
+    
+    // Коефіцієнти Тейлора f^(k)(x) / k! для k = 0..order за один прохід: кожен регістр
+    // тримає обрізаний ряд, а операції над рядами йдуть за рекурентними формулами,
+    // тож ціна — O(size() * order^2) без жодної символьної похідної.
+    // Рекурентні формули для 1/a, a^p і ln(a) ділять на a(x), тому при нульовій
+    // основі й order > 0 кидається std::domain_error: ряд там може не існувати
+    // (x^2.5 у нулі), і вирішувати це має той, хто викликає
+    std::vector<double> taylor(double x, size_t order) const {
+        if (code.empty()) throw std::logic_error("Expression program is empty");
+        
+        const size_t n = order + 1;
+        auto requireNonZeroBase = [n](const double* a) {
+            if (n > 1 && a[0] == 0.0) {
+                throw std::domain_error("Taylor recurrence is undefined for a zero base");
+            }
+        };
+        std::vector<double> series(code.size() * n, 0.0);
+        std::vector<double> paired(n);
+        for (size_t i = 0; i < code.size(); ++i) {
+            const Instruction& in = code[i];
+            double* c = series.data() + i * n;
+            const double* a = series.data() + in.a * n;
+            const double* b = series.data() + in.b * n;
+            switch (in.op) {
+                case OpCode::Const:
+                    c[0] = in.value;
+                    break;
+                case OpCode::LoadX:
+                    c[0] = x;
+                    if (n > 1) c[1] = 1.0;
+                    break;
+                case OpCode::Add:
+                    for (size_t k = 0; k < n; ++k) c[k] = a[k] + b[k];
+                    break;
+                case OpCode::AddConst:
+                    std::copy(a, a + n, c);
+                    c[0] += in.value;
+                    break;
+                case OpCode::Mul:
+                case OpCode::Square:
+                    if (in.op == OpCode::Square) b = a;
+                    for (size_t k = 0; k < n; ++k) {
+                        double sum = 0.0;
+                        for (size_t j = 0; j <= k; ++j) sum += a[j] * b[k - j];
+                        c[k] = sum;
+                    }
+                    break;
+                case OpCode::MulConst:
+                    for (size_t k = 0; k < n; ++k) c[k] = a[k] * in.value;
+                    break;
+                case OpCode::Reciprocal:
+                    // a * c = 1
+                    requireNonZeroBase(a);
+                    c[0] = 1.0 / a[0];
+                    for (size_t k = 1; k < n; ++k) {
+                        double sum = 0.0;
+                        for (size_t j = 1; j <= k; ++j) sum += a[j] * c[k - j];
+                        c[k] = -sum * c[0];
+                    }
+                    break;
+                case OpCode::Pow:
+                    // a * c' = p * a' * c
+                    requireNonZeroBase(a);
+                    c[0] = std::pow(a[0], in.value);
+                    for (size_t k = 1; k < n; ++k) {
+                        double sum = 0.0;
+                        for (size_t j = 1; j <= k; ++j) {
+                            sum += (in.value * j - (k - j)) * a[j] * c[k - j];
+                        }
+                        c[k] = sum / (k * a[0]);
+                    }
+                    break;
+                case OpCode::Exp:
+                    // c' = a' * c
+                    c[0] = std::exp(a[0]);
+                    for (size_t k = 1; k < n; ++k) {
+                        double sum = 0.0;
+                        for (size_t j = 1; j <= k; ++j) sum += j * a[j] * c[k - j];
+                        c[k] = sum / k;
+                    }
+                    break;
+                case OpCode::Ln:
+                    // a * c' = a'
+                    requireNonZeroBase(a);
+                    c[0] = std::log(a[0]);
+                    for (size_t k = 1; k < n; ++k) {
+                        double sum = 0.0;
+                        for (size_t j = 1; j < k; ++j) sum += j * c[j] * a[k - j];
+                        c[k] = (a[k] - sum / k) / a[0];
+                    }
+                    break;
+                case OpCode::Sin:
+                case OpCode::Cos: {
+                    // sin і cos рахуються парою: s' = a' * co, co' = -a' * s
+                    double* s = in.op == OpCode::Sin ? c : paired.data();
+                    double* co = in.op == OpCode::Sin ? paired.data() : c;
+                    s[0] = std::sin(a[0]);
+                    co[0] = std::cos(a[0]);
+                    for (size_t k = 1; k < n; ++k) {
+                        double sinSum = 0.0, cosSum = 0.0;
+                        for (size_t j = 1; j <= k; ++j) {
+                            sinSum += j * a[j] * co[k - j];
+                            cosSum += j * a[j] * s[k - j];
+                        }
+                        s[k] = sinSum / k;
+                        co[k] = -cosSum / k;
+                    }
+                    break;
+                }
+            }
+        }
+        return std::vector<double>(series.begin() + result * n, series.begin() + (result + 1) * n);
+    }
+    
+    // Обчислення блоку з m точок: регістр i займає stride значень з r + i * stride.
+    // Кожна інструкція — простий цикл по блоку, тож арифметику векторизує компілятор,
+    // а switch виконується раз на блок, а не на точку
+    void evaluateBlock(const double* x, size_t m, size_t stride, double* r) const {
+        for (size_t i = 0; i < code.size(); ++i) {
+            const Instruction& in = code[i];
+            double* dst = r + i * stride;
+            const double* a = r + in.a * stride;
+            const double* b = r + in.b * stride;
+            const double value = in.value;
+            switch (in.op) {
+                case OpCode::Const: std::fill(dst, dst + m, value); break;
+                case OpCode::LoadX: std::copy(x, x + m, dst); break;
+                case OpCode::Add: for (size_t k = 0; k < m; ++k) dst[k] = a[k] + b[k]; break;
+                case OpCode::Mul: for (size_t k = 0; k < m; ++k) dst[k] = a[k] * b[k]; break;
+                case OpCode::AddConst: for (size_t k = 0; k < m; ++k) dst[k] = a[k] + value; break;
+                case OpCode::MulConst: for (size_t k = 0; k < m; ++k) dst[k] = a[k] * value; break;
+                case OpCode::Square: for (size_t k = 0; k < m; ++k) dst[k] = a[k] * a[k]; break;
+                case OpCode::Reciprocal: for (size_t k = 0; k < m; ++k) dst[k] = 1.0 / a[k]; break;
+                case OpCode::Pow: for (size_t k = 0; k < m; ++k) dst[k] = std::pow(a[k], value); break;
+                case OpCode::Sin: for (size_t k = 0; k < m; ++k) dst[k] = std::sin(a[k]); break;
+                case OpCode::Cos: for (size_t k = 0; k < m; ++k) dst[k] = std::cos(a[k]); break;
+                case OpCode::Exp: for (size_t k = 0; k < m; ++k) dst[k] = std::exp(a[k]); break;
+                case OpCode::Ln: for (size_t k = 0; k < m; ++k) dst[k] = std::log(a[k]); break;
+            }
+        }
+    }
+    
+    // out[k] = f(xs[k]) для k < n; out може збігатися з xs
+    void evaluate(const double* xs, double* out, size_t n) const {
+        if (code.empty()) throw std::logic_error("Expression program is empty");
+        if (n == 0) return;
+        
+        size_t block = std::max<size_t>(8, std::min(maxBlock, blockRegisterBudget / code.size()));
+        thread_local std::vector<double> registers;
+        if (registers.size() < code.size() * block) registers.resize(code.size() * block);
+        
+        for (size_t start = 0; start < n; start += block) {
+            size_t m = std::min(block, n - start);
+            evaluateBlock(xs + start, m, block, registers.data());
+            const double* value = registers.data() + result * block;
+            std::copy(value, value + m, out + start);
+        }
+    }
+    
+    std::string toString() const {
+        static const char* names[] = { "const", "x", "add", "mul", "addc", "mulc", "square", "recip",
+                                       "pow", "sin", "cos", "exp", "ln" };
+        std::ostringstream oss;
+        for (size_t i = 0; i < code.size(); ++i) {
+            const Instruction& in = code[i];
+            oss << "r" << i << " = " << names[static_cast<int>(in.op)];
+            switch (in.op) {
+                case OpCode::Const: oss << " " << in.value; break;
+                case OpCode::LoadX: break;
+                case OpCode::Add:
+                case OpCode::Mul: oss << " r" << in.a << ", r" << in.b; break;
+                case OpCode::AddConst:
+                case OpCode::MulConst:
+                case OpCode::Pow: oss << " r" << in.a << ", " << in.value; break;
+                default: oss << " r" << in.a; break;
+            }
+            oss << "\n";
+        }
+        oss << "return r" << result << "\n";
+        return oss.str();
+    }
+};
+
+#endif
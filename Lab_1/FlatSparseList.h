@@ -0,0 +1,304 @@
+#ifndef FLATSPARSELIST_H
+#define FLATSPARSELIST_H
+
+#include "ISparseContainer.h"
+#include "SparseBinaryFormat.h"
+#include "SparseRandom.h"
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <type_traits>
+#include <iterator>
+#include <cstddef>
+
+// Розріджений список на двох відсортованих масивах indices/values.
+// Записи нових індексів потрапляють у невеликий невпорядкований буфер і зливаються
+// з масивами пакетно, коли буфер переповнюється або потрібен впорядкований обхід.
+// Злиття може відбуватися і в const-методах, тому одночасні читання з різних потоків
+// безпечні лише після compact()
+template<typename T>
+class FlatSparseList : public ISparseContainer<T> {
+private:
+    mutable std::vector<size_t> indices;
+    mutable std::vector<T> values;
+    mutable std::vector<std::pair<size_t, T>> pending;
+    size_t listSize;
+    T defaultValue;
+    
+    size_t pendingLimit() const {
+        return std::max<size_t>(32, static_cast<size_t>(std::sqrt(static_cast<double>(indices.size()))));
+    }
+    
+    size_t find(size_t index) const {
+        auto it = std::lower_bound(indices.begin(), indices.end(), index);
+        return (it != indices.end() && *it == index) ? static_cast<size_t>(it - indices.begin()) : indices.size();
+    }
+    
+public:
+    FlatSparseList(size_t size = 0, const T& defVal = T())
+        : listSize(size), defaultValue(defVal) {}
+    
+    // Зливає буфер вставок з відсортованими масивами; останній запис індексу перемагає
+    void compact() const {
+        if (pending.empty()) return;
+        
+        std::stable_sort(pending.begin(), pending.end(),
+            [](const std::pair<size_t, T>& a, const std::pair<size_t, T>& b) { return a.first < b.first; });
+        
+        std::vector<size_t> mergedIndices;
+        std::vector<T> mergedValues;
+        mergedIndices.reserve(indices.size() + pending.size());
+        mergedValues.reserve(indices.size() + pending.size());
+        
+        size_t a = 0, b = 0;
+        while (a < indices.size() || b < pending.size()) {
+            if (b == pending.size() || (a < indices.size() && indices[a] < pending[b].first)) {
+                mergedIndices.push_back(indices[a]);
+                mergedValues.push_back(values[a]);
+                ++a;
+                continue;
+            }
+            size_t index = pending[b].first;
+            while (b + 1 < pending.size() && pending[b + 1].first == index) ++b;
+            if (a < indices.size() && indices[a] == index) ++a;
+            if (!(pending[b].second == defaultValue)) {
+                mergedIndices.push_back(index);
+                mergedValues.push_back(pending[b].second);
+            }
+            ++b;
+        }
+        
+        indices.swap(mergedIndices);
+        values.swap(mergedValues);
+        pending.clear();
+    }
+    
+    T get(size_t index) const override {
+        if (index >= listSize) {
+            throw std::out_of_range("Index out of range");
+        }
+        for (auto it = pending.rbegin(); it != pending.rend(); ++it) {
+            if (it->first == index) return it->second;
+        }
+        size_t pos = find(index);
+        return (pos != indices.size()) ? values[pos] : defaultValue;
+    }
+    
+    void set(size_t index, const T& value) override {
+        if (index >= listSize) {
+            listSize = index + 1;
+        }
+        
+        size_t pos = find(index);
+        if (pos != indices.size() && !(value == defaultValue)) {
+            values[pos] = value;
+            for (auto& entry : pending) {
+                if (entry.first == index) entry.second = value;
+            }
+            return;
+        }
+        if (pos == indices.size() && value == defaultValue && pending.empty()) {
+            return;
+        }
+        
+        pending.emplace_back(index, value);
+        if (pending.size() > pendingLimit()) compact();
+    }
+    
+    class const_iterator {
+    private:
+        const FlatSparseList<T>* list;
+        size_t pos;
+        
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = SparseEntry<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = SparseEntry<T>;
+        
+        const_iterator(const FlatSparseList<T>* l, size_t p) : list(l), pos(p) {}
+        
+        SparseEntry<T> operator*() const { return SparseEntry<T>{list->indices[pos], list->values[pos]}; }
+        const_iterator& operator++() { ++pos; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++pos; return old; }
+        bool operator==(const const_iterator& other) const { return pos == other.pos; }
+        bool operator!=(const const_iterator& other) const { return pos != other.pos; }
+    };
+    
+    const_iterator begin() const {
+        compact();
+        return const_iterator(this, 0);
+    }
+    
+    const_iterator end() const {
+        compact();
+        return const_iterator(this, indices.size());
+    }
+    
+    void forEachNonZero(const std::function<void(size_t, const T&)>& visit) const override {
+        compact();
+        for (size_t i = 0; i < indices.size(); ++i) {
+            visit(indices[i], values[i]);
+        }
+    }
+    
+    int findByValue(const T& value) const override {
+        compact();
+        if (value == defaultValue) {
+            for (size_t i = 0; i < indices.size(); ++i) {
+                if (indices[i] != i) return static_cast<int>(i);
+            }
+            return indices.size() < listSize ? static_cast<int>(indices.size()) : -1;
+        }
+        
+        auto it = std::find(values.begin(), values.end(), value);
+        return it != values.end() ? static_cast<int>(indices[it - values.begin()]) : -1;
+    }
+    
+    int findFirstBy(std::function<bool(const T&)> predicate) const override {
+        compact();
+        size_t firstDefault = listSize;
+        if (predicate(defaultValue)) {
+            firstDefault = indices.size() < listSize ? indices.size() : listSize;
+            for (size_t i = 0; i < indices.size(); ++i) {
+                if (indices[i] != i) {
+                    firstDefault = i;
+                    break;
+                }
+            }
+        }
+        
+        for (size_t i = 0; i < indices.size() && indices[i] < firstDefault; ++i) {
+            if (predicate(values[i])) return static_cast<int>(indices[i]);
+        }
+        return firstDefault < listSize ? static_cast<int>(firstDefault) : -1;
+    }
+    
+    size_t size() const override {
+        return listSize;
+    }
+    
+    size_t nonZeroCount() const override {
+        compact();
+        return indices.size();
+    }
+    
+    std::string toString() const override {
+        compact();
+        std::ostringstream oss;
+        oss << "FlatSparseList[size=" << listSize << ", stored=" << indices.size() << "]: [";
+        size_t pos = 0;
+        for (size_t i = 0; i < std::min(listSize, size_t(10)); ++i) {
+            if (i > 0) oss << ", ";
+            if (pos < indices.size() && indices[pos] == i) {
+                oss << values[pos++];
+            } else {
+                oss << defaultValue;
+            }
+        }
+        if (listSize > 10) oss << ", ...";
+        oss << "]";
+        return oss.str();
+    }
+    
+    void clear() override {
+        indices.clear();
+        values.clear();
+        pending.clear();
+        listSize = 0;
+    }
+    
+    void saveToFile(const std::string& filename) const override {
+        std::ofstream out(filename);
+        if (!out) throw std::runtime_error("Cannot open file for writing");
+        
+        compact();
+        out << "FlatSparseList\n";
+        out << listSize << "\n";
+        out << indices.size() << "\n";
+        for (size_t i = 0; i < indices.size(); ++i) {
+            out << indices[i] << " " << values[i] << "\n";
+        }
+    }
+    
+    // Приймає і файли SparseList: вміст обох форматів однаковий
+    void loadFromFile(const std::string& filename) override {
+        std::ifstream in(filename);
+        if (!in) throw std::runtime_error("Cannot open file for reading");
+        
+        std::string type;
+        in >> type;
+        if (type != "FlatSparseList" && type != "SparseList") throw std::runtime_error("Invalid file format");
+        
+        size_t sz, count;
+        in >> sz >> count;
+        
+        clear();
+        listSize = sz;
+        for (size_t i = 0; i < count; ++i) {
+            size_t idx;
+            T val;
+            in >> idx >> val;
+            pending.emplace_back(idx, val);
+        }
+        compact();
+    }
+    
+    void saveBinary(const std::string& filename) const {
+        static_assert(std::is_trivially_copyable<T>::value, "Binary format requires trivially copyable values");
+        
+        compact();
+        SparseBinaryWriter writer(filename, SparseBinaryKind::List, listSize, 1, indices.size(), sizeof(T));
+        writer.writeArray(&defaultValue, sizeof(T));
+        writer.writeIndices(indices.data(), indices.size());
+        writer.writeArray(values.data(), values.size() * sizeof(T));
+        writer.finish();
+    }
+    
+    void loadBinary(const std::string& filename) {
+        static_assert(std::is_trivially_copyable<T>::value, "Binary format requires trivially copyable values");
+        
+        SparseBinaryReader reader(filename, SparseBinaryKind::List, sizeof(T));
+        const SparseBinaryHeader& header = reader.getHeader();
+        
+        T defVal;
+        std::vector<size_t> loadedIndices(header.nonZeros);
+        std::vector<T> loadedValues(header.nonZeros);
+        reader.readArray(&defVal, sizeof(T));
+        reader.readIndices(loadedIndices.data(), loadedIndices.size());
+        reader.readArray(loadedValues.data(), loadedValues.size() * sizeof(T));
+        reader.verify();
+        
+        if (!sparseBinaryValidList(loadedIndices.data(), header.rows, header.nonZeros)) {
+            throw std::runtime_error("Invalid file format");
+        }
+        clear();
+        listSize = header.rows;
+        defaultValue = defVal;
+        indices.swap(loadedIndices);
+        values.swap(loadedValues);
+    }
+    
+    void generateRandom(size_t size, double density, std::function<T()> generator,
+                        uint64_t seed = static_cast<uint64_t>(std::rand())) {
+        clear();
+        listSize = size;
+        size_t count = std::min(size, static_cast<size_t>(size * density));
+        
+        Xoshiro256 rng(seed);
+        std::vector<uint64_t> positions;
+        sampleWithoutReplacement(size, count, rng, positions);
+        indices.assign(positions.begin(), positions.end());
+        values.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            values.push_back(drawNonDefault(generator, defaultValue));
+        }
+    }
+};
+
+#endif
\ No newline at end of file
@@ -3,6 +3,15 @@
 
 #include <string>
 #include <functional>
+#include <cstddef>
+
+// Збережений елемент контейнера; розіменування ітераторів begin()/end() конкретних
+// контейнерів повертає цю пару, тож обхід іде лише по ненульових елементах
+template<typename T>
+struct SparseEntry {
+    size_t index;
+    const T& value;
+};
 
 template<typename T>
 class ISparseContainer {
@@ -17,6 +26,7 @@ public:
     
     virtual size_t size() const = 0;
     virtual size_t nonZeroCount() const = 0;
+    virtual void forEachNonZero(const std::function<void(size_t, const T&)>& visit) const = 0;
     virtual std::string toString() const = 0;
     virtual void clear() = 0;
     
@@ -0,0 +1,474 @@
+#ifndef ITERATIVESOLVERS_H
+#define ITERATIVESOLVERS_H
+
+#include "SparseMatrix.h"
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+
+// Ітераційні методи розв'язання Ax = b поверх інтерфейсу SparseMatrix.
+// Матриця використовується лише через multiplyVector(x, y), тому підходить будь-який формат.
+// Робочі вектори живуть у самому розв'язувачі й лише змінюють розмір між викликами solve,
+// тож повторні розв'язання систем одного розміру не виділяють пам'ять
+struct SolverOptions {
+    size_t maxIterations = 1000;
+    double tolerance = 1e-8;     // відносна нев'язка ||b - Ax|| / ||b||
+    size_t restart = 30;         // розмір підпростору Крилова для GMRES
+};
+
+struct SolverResult {
+    size_t iterations = 0;
+    double residual = 0.0;       // відносна нев'язка після останньої ітерації
+    bool converged = false;
+    double seconds = 0.0;
+};
+
+// Передобумовлювач M ≈ A: apply розв'язує Mz = r
+template<typename T>
+class Preconditioner {
+public:
+    virtual ~Preconditioner() = default;
+    virtual void apply(const std::vector<T>& r, std::vector<T>& z) const = 0;
+};
+
+// Діагональний передобумовлювач: z = r / diag(A)
+template<typename T>
+class JacobiPreconditioner : public Preconditioner<T> {
+private:
+    std::vector<T> inverseDiagonal;
+    
+public:
+    explicit JacobiPreconditioner(const SparseMatrix<T>& matrix) {
+        if (matrix.getRows() != matrix.getCols()) {
+            throw std::invalid_argument("Preconditioner requires a square matrix");
+        }
+        
+        inverseDiagonal.resize(matrix.getRows());
+        for (size_t i = 0; i < matrix.getRows(); ++i) {
+            T diagonal = matrix.get(i, i);
+            if (diagonal == T()) {
+                throw std::invalid_argument("Jacobi preconditioner requires a nonzero diagonal");
+            }
+            inverseDiagonal[i] = T(1) / diagonal;
+        }
+    }
+    
+    void apply(const std::vector<T>& r, std::vector<T>& z) const override {
+        z.resize(r.size());
+        for (size_t i = 0; i < r.size(); ++i) {
+            z[i] = r[i] * inverseDiagonal[i];
+        }
+    }
+};
+
+// Неповна LU-факторизація без заповнення: L і U мають ту саму структуру, що й A.
+// Обидва множники зберігаються в одному наборі CSR-масивів, одинична діагональ L не зберігається
+template<typename T>
+class ILU0Preconditioner : public Preconditioner<T> {
+private:
+    std::vector<T> values;
+    std::vector<size_t> colIndices;
+    std::vector<size_t> rowPointers;
+    std::vector<size_t> diagonal;
+    
+public:
+    explicit ILU0Preconditioner(const CSRSparseMatrix<T>& matrix)
+        : values(matrix.getValues()), colIndices(matrix.getColIndices()),
+          rowPointers(matrix.getRowPointers()) {
+        size_t n = matrix.getRows();
+        if (n != matrix.getCols()) {
+            throw std::invalid_argument("Preconditioner requires a square matrix");
+        }
+        
+        diagonal.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            auto first = colIndices.begin() + rowPointers[i];
+            auto last = colIndices.begin() + rowPointers[i + 1];
+            auto it = std::lower_bound(first, last, i);
+            if (it == last || *it != i) {
+                throw std::invalid_argument("ILU(0) requires every diagonal entry to be stored");
+            }
+            diagonal[i] = it - colIndices.begin();
+        }
+        
+        // Варіант IKJ: позиції рядка i відмічаються, щоб оновлювати лише наявні елементи
+        const size_t unmarked = std::numeric_limits<size_t>::max();
+        std::vector<size_t> position(n, unmarked);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t a = rowPointers[i]; a < rowPointers[i + 1]; ++a) {
+                position[colIndices[a]] = a;
+            }
+            
+            for (size_t a = rowPointers[i]; a < diagonal[i]; ++a) {
+                size_t k = colIndices[a];
+                if (values[diagonal[k]] == T()) {
+                    throw std::runtime_error("ILU(0) breakdown: zero pivot");
+                }
+                values[a] = values[a] / values[diagonal[k]];
+                for (size_t b = diagonal[k] + 1; b < rowPointers[k + 1]; ++b) {
+                    size_t j = position[colIndices[b]];
+                    if (j != unmarked) {
+                        values[j] = values[j] - values[a] * values[b];
+                    }
+                }
+            }
+            
+            for (size_t a = rowPointers[i]; a < rowPointers[i + 1]; ++a) {
+                position[colIndices[a]] = unmarked;
+            }
+            if (values[diagonal[i]] == T()) {
+                throw std::runtime_error("ILU(0) breakdown: zero pivot");
+            }
+        }
+    }
+    
+    explicit ILU0Preconditioner(const MapSparseMatrix<T>& matrix)
+        : ILU0Preconditioner(matrix.toCSR()) {}
+    
+    void apply(const std::vector<T>& r, std::vector<T>& z) const override {
+        size_t n = diagonal.size();
+        z.resize(n);
+        
+        for (size_t i = 0; i < n; ++i) {
+            T sum = r[i];
+            for (size_t a = rowPointers[i]; a < diagonal[i]; ++a) {
+                sum = sum - values[a] * z[colIndices[a]];
+            }
+            z[i] = sum;
+        }
+        for (size_t i = n; i-- > 0;) {
+            T sum = z[i];
+            for (size_t a = diagonal[i] + 1; a < rowPointers[i + 1]; ++a) {
+                sum = sum - values[a] * z[colIndices[a]];
+            }
+            z[i] = sum / values[diagonal[i]];
+        }
+    }
+};
+
+template<typename T>
+class IterativeSolver {
+protected:
+    SolverOptions options;
+    
+    static T dot(const std::vector<T>& a, const std::vector<T>& b) {
+        T sum = T();
+        for (size_t i = 0; i < a.size(); ++i) {
+            sum = sum + a[i] * b[i];
+        }
+        return sum;
+    }
+    
+    static double norm(const std::vector<T>& v) {
+        return std::sqrt(static_cast<double>(dot(v, v)));
+    }
+    
+    static void precondition(const Preconditioner<T>* preconditioner, const std::vector<T>& r, std::vector<T>& z) {
+        if (preconditioner) {
+            preconditioner->apply(r, z);
+        } else {
+            z.assign(r.begin(), r.end());
+        }
+    }
+    
+    // r = b - Ax; Ax рахується в r, щоб не тримати окремий вектор
+    static void residual(const SparseMatrix<T>& matrix, const std::vector<T>& b,
+                         const std::vector<T>& x, std::vector<T>& r) {
+        matrix.multiplyVector(x, r);
+        for (size_t i = 0; i < r.size(); ++i) {
+            r[i] = b[i] - r[i];
+        }
+    }
+    
+    static void checkSystem(const SparseMatrix<T>& matrix, const std::vector<T>& b, std::vector<T>& x) {
+        if (matrix.getRows() != matrix.getCols()) {
+            throw std::invalid_argument("Iterative solvers require a square matrix");
+        }
+        if (matrix.getDefaultValue() != T()) {
+            throw std::invalid_argument("Iterative solvers require a zero default value");
+        }
+        if (b.size() != matrix.getRows()) {
+            throw std::invalid_argument("Right-hand side size must match matrix rows");
+        }
+        if (x.size() != b.size()) {
+            x.assign(b.size(), T());
+        }
+    }
+    
+    static double seconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    
+public:
+    explicit IterativeSolver(const SolverOptions& opts) : options(opts) {}
+    virtual ~IterativeSolver() = default;
+    
+    const SolverOptions& getOptions() const { return options; }
+    void setOptions(const SolverOptions& opts) { options = opts; }
+    
+    // x — початкове наближення (якщо розмір не збігається з b, починаємо з нуля) і результат
+    virtual SolverResult solve(const SparseMatrix<T>& matrix, const std::vector<T>& b, std::vector<T>& x,
+                               const Preconditioner<T>* preconditioner = nullptr) = 0;
+};
+
+// Метод спряжених градієнтів: для симетричних додатно визначених матриць
+template<typename T>
+class ConjugateGradientSolver : public IterativeSolver<T> {
+private:
+    std::vector<T> r, z, p, q;
+    
+    using IterativeSolver<T>::options;
+    
+public:
+    explicit ConjugateGradientSolver(const SolverOptions& opts = SolverOptions())
+        : IterativeSolver<T>(opts) {}
+    
+    SolverResult solve(const SparseMatrix<T>& matrix, const std::vector<T>& b, std::vector<T>& x,
+                       const Preconditioner<T>* preconditioner = nullptr) override {
+        auto start = std::chrono::steady_clock::now();
+        this->checkSystem(matrix, b, x);
+        SolverResult result;
+        
+        double bNorm = this->norm(b);
+        if (bNorm == 0.0) bNorm = 1.0;
+        
+        this->residual(matrix, b, x, r);
+        result.residual = this->norm(r) / bNorm;
+        this->precondition(preconditioner, r, z);
+        p.assign(z.begin(), z.end());
+        T rz = this->dot(r, z);
+        
+        while (result.residual > options.tolerance && result.iterations < options.maxIterations) {
+            matrix.multiplyVector(p, q);
+            T pq = this->dot(p, q);
+            if (pq == T()) break;
+            T alpha = rz / pq;
+            for (size_t i = 0; i < x.size(); ++i) {
+                x[i] = x[i] + alpha * p[i];
+                r[i] = r[i] - alpha * q[i];
+            }
+            ++result.iterations;
+            result.residual = this->norm(r) / bNorm;
+            if (result.residual <= options.tolerance) break;
+            
+            this->precondition(preconditioner, r, z);
+            T rzNext = this->dot(r, z);
+            T beta = rzNext / rz;
+            rz = rzNext;
+            for (size_t i = 0; i < p.size(); ++i) {
+                p[i] = z[i] + beta * p[i];
+            }
+        }
+        
+        result.converged = result.residual <= options.tolerance;
+        result.seconds = this->seconds(start);
+        return result;
+    }
+};
+
+// BiCGSTAB з правим передобумовленням: для несиметричних матриць, дві операції SpMV на ітерацію
+template<typename T>
+class BiCGSTABSolver : public IterativeSolver<T> {
+private:
+    std::vector<T> r, rHat, p, pHat, v, s, sHat, t;
+    
+    using IterativeSolver<T>::options;
+    
+public:
+    explicit BiCGSTABSolver(const SolverOptions& opts = SolverOptions())
+        : IterativeSolver<T>(opts) {}
+    
+    SolverResult solve(const SparseMatrix<T>& matrix, const std::vector<T>& b, std::vector<T>& x,
+                       const Preconditioner<T>* preconditioner = nullptr) override {
+        auto start = std::chrono::steady_clock::now();
+        this->checkSystem(matrix, b, x);
+        SolverResult result;
+        size_t n = b.size();
+        
+        double bNorm = this->norm(b);
+        if (bNorm == 0.0) bNorm = 1.0;
+        
+        this->residual(matrix, b, x, r);
+        result.residual = this->norm(r) / bNorm;
+        rHat.assign(r.begin(), r.end());
+        p.assign(n, T());
+        v.assign(n, T());
+        T rho = T(1), alpha = T(1), omega = T(1);
+        
+        while (result.residual > options.tolerance && result.iterations < options.maxIterations) {
+            T rhoNext = this->dot(rHat, r);
+            if (rhoNext == T()) break;
+            T beta = (rhoNext / rho) * (alpha / omega);
+            rho = rhoNext;
+            for (size_t i = 0; i < n; ++i) {
+                p[i] = r[i] + beta * (p[i] - omega * v[i]);
+            }
+            
+            this->precondition(preconditioner, p, pHat);
+            matrix.multiplyVector(pHat, v);
+            T rHatV = this->dot(rHat, v);
+            if (rHatV == T()) break;
+            alpha = rho / rHatV;
+            
+            s.resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                s[i] = r[i] - alpha * v[i];
+            }
+            ++result.iterations;
+            
+            double sNorm = this->norm(s) / bNorm;
+            if (sNorm <= options.tolerance) {
+                for (size_t i = 0; i < n; ++i) {
+                    x[i] = x[i] + alpha * pHat[i];
+                }
+                r.swap(s);
+                result.residual = sNorm;
+                break;
+            }
+            
+            this->precondition(preconditioner, s, sHat);
+            matrix.multiplyVector(sHat, t);
+            T tt = this->dot(t, t);
+            omega = (tt == T()) ? T() : this->dot(t, s) / tt;
+            for (size_t i = 0; i < n; ++i) {
+                x[i] = x[i] + alpha * pHat[i] + omega * sHat[i];
+                r[i] = s[i] - omega * t[i];
+            }
+            result.residual = this->norm(r) / bNorm;
+            if (omega == T()) break;
+        }
+        
+        result.converged = result.residual <= options.tolerance;
+        result.seconds = this->seconds(start);
+        return result;
+    }
+};
+
+// GMRES з перезапуском і правим передобумовленням. Базис Крилова будується модифікованим
+// Грамом-Шмідтом, матриця Гессенберга приводиться до трикутної обертаннями Гівенса,
+// тому нев'язка відома на кожному кроці без обчислення x
+template<typename T>
+class GMRESSolver : public IterativeSolver<T> {
+private:
+    std::vector<std::vector<T>> basis;
+    std::vector<T> hessenberg;   // (restart + 1) x restart, по стовпцях
+    std::vector<T> cosines, sines, g, y;
+    std::vector<T> r, w, z;
+    
+    using IterativeSolver<T>::options;
+    
+    T& h(size_t i, size_t j) {
+        return hessenberg[j * (options.restart + 1) + i];
+    }
+    
+public:
+    explicit GMRESSolver(const SolverOptions& opts = SolverOptions())
+        : IterativeSolver<T>(opts) {}
+    
+    SolverResult solve(const SparseMatrix<T>& matrix, const std::vector<T>& b, std::vector<T>& x,
+                       const Preconditioner<T>* preconditioner = nullptr) override {
+        auto start = std::chrono::steady_clock::now();
+        this->checkSystem(matrix, b, x);
+        if (options.restart == 0) {
+            throw std::invalid_argument("GMRES restart length must be positive");
+        }
+        SolverResult result;
+        size_t n = b.size();
+        size_t m = options.restart;
+        
+        basis.resize(m + 1);
+        for (auto& v : basis) v.resize(n);
+        hessenberg.assign((m + 1) * m, T());
+        cosines.resize(m);
+        sines.resize(m);
+        g.resize(m + 1);
+        y.resize(m);
+        
+        double bNorm = this->norm(b);
+        if (bNorm == 0.0) bNorm = 1.0;
+        
+        this->residual(matrix, b, x, r);
+        double beta = this->norm(r);
+        result.residual = beta / bNorm;
+        
+        while (result.residual > options.tolerance && result.iterations < options.maxIterations) {
+            for (size_t i = 0; i < n; ++i) {
+                basis[0][i] = r[i] / static_cast<T>(beta);
+            }
+            std::fill(g.begin(), g.end(), T());
+            g[0] = static_cast<T>(beta);
+            
+            size_t k = 0;
+            while (k < m && result.iterations < options.maxIterations) {
+                this->precondition(preconditioner, basis[k], z);
+                matrix.multiplyVector(z, w);
+                
+                for (size_t i = 0; i <= k; ++i) {
+                    h(i, k) = this->dot(w, basis[i]);
+                    for (size_t j = 0; j < n; ++j) {
+                        w[j] = w[j] - h(i, k) * basis[i][j];
+                    }
+                }
+                h(k + 1, k) = static_cast<T>(this->norm(w));
+                if (h(k + 1, k) != T()) {
+                    for (size_t j = 0; j < n; ++j) {
+                        basis[k + 1][j] = w[j] / h(k + 1, k);
+                    }
+                }
+                
+                for (size_t i = 0; i < k; ++i) {
+                    T temp = cosines[i] * h(i, k) + sines[i] * h(i + 1, k);
+                    h(i + 1, k) = -sines[i] * h(i, k) + cosines[i] * h(i + 1, k);
+                    h(i, k) = temp;
+                }
+                T denominator = static_cast<T>(std::hypot(static_cast<double>(h(k, k)),
+                                                          static_cast<double>(h(k + 1, k))));
+                if (denominator == T()) break;
+                cosines[k] = h(k, k) / denominator;
+                sines[k] = h(k + 1, k) / denominator;
+                h(k, k) = denominator;
+                h(k + 1, k) = T();
+                g[k + 1] = -sines[k] * g[k];
+                g[k] = cosines[k] * g[k];
+                
+                ++k;
+                ++result.iterations;
+                result.residual = std::abs(static_cast<double>(g[k])) / bNorm;
+                if (result.residual <= options.tolerance) break;
+            }
+            if (k == 0) break;
+            
+            // Зворотна підстановка для Hy = g і поправка x += M^-1 V y
+            for (size_t i = k; i-- > 0;) {
+                T sum = g[i];
+                for (size_t j = i + 1; j < k; ++j) {
+                    sum = sum - h(i, j) * y[j];
+                }
+                y[i] = sum / h(i, i);
+            }
+            w.assign(n, T());
+            for (size_t j = 0; j < k; ++j) {
+                for (size_t i = 0; i < n; ++i) {
+                    w[i] = w[i] + y[j] * basis[j][i];
+                }
+            }
+            this->precondition(preconditioner, w, z);
+            for (size_t i = 0; i < n; ++i) {
+                x[i] = x[i] + z[i];
+            }
+            
+            this->residual(matrix, b, x, r);
+            beta = this->norm(r);
+            result.residual = beta / bNorm;
+        }
+        
+        result.converged = result.residual <= options.tolerance;
+        result.seconds = this->seconds(start);
+        return result;
+    }
+};
+
+#endif
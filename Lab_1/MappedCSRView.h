@@ -0,0 +1,210 @@
+#ifndef MAPPEDCSRVIEW_H
+#define MAPPEDCSRVIEW_H
+
+#include "SparseBinaryFormat.h"
+#include "SimdKernels.h"
+#include <string>
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Відображення файлу в пам'ять лише для читання
+class MappedFile {
+private:
+    const unsigned char* data = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+    
+    void release() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+        mapping = nullptr;
+#else
+        if (data) munmap(const_cast<unsigned char*>(data), length);
+#endif
+        data = nullptr;
+        length = 0;
+    }
+    
+public:
+    explicit MappedFile(const std::string& filename) {
+#ifdef _WIN32
+        file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Cannot open file for reading");
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            release();
+            throw std::runtime_error("Cannot determine file size");
+        }
+        length = static_cast<size_t>(size.QuadPart);
+        if (length > 0) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping) data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (!data) {
+                release();
+                throw std::runtime_error("Cannot map file into memory");
+            }
+        }
+#else
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open file for reading");
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw std::runtime_error("Cannot determine file size");
+        }
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            void* mapped = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapped == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Cannot map file into memory");
+            }
+            data = static_cast<const unsigned char*>(mapped);
+        }
+        close(fd);
+#endif
+    }
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    ~MappedFile() {
+        release();
+    }
+    
+    const unsigned char* begin() const { return data; }
+    size_t size() const { return length; }
+};
+
+// CSR-матриця, що читається прямо з файлу saveBinary без копіювання масивів.
+// Сторінки підвантажуються ОС при першому доступі, тож відкриття коштує O(1): перевіряються
+// лише заголовок, довжина файлу й крайні вказівники рядків. Повний прохід по індексах
+// (verifyStructure) і контрольна сума (verifyChecksum) вмикаються для ненадійних файлів
+template<typename T>
+class MappedCSRView {
+private:
+    static_assert(std::is_trivially_copyable<T>::value, "Binary format requires trivially copyable values");
+    static_assert(sizeof(size_t) == sizeof(uint64_t), "Mapped view requires 64-bit size_t");
+    
+    MappedFile file;
+    size_t rows = 0, cols = 0, nonZeros = 0;
+    T defaultValue;
+    const size_t* rowPointers = nullptr;
+    const size_t* colIndices = nullptr;
+    const T* values = nullptr;
+    
+public:
+    explicit MappedCSRView(const std::string& filename, bool verifyChecksum = false, bool verifyStructure = false)
+        : file(filename) {
+        if (file.size() < sizeof(SparseBinaryHeader)) throw std::runtime_error("Invalid file format");
+        
+        SparseBinaryHeader header;
+        std::memcpy(&header, file.begin(), sizeof(header));
+        if (std::memcmp(header.magic, SPARSE_BINARY_MAGIC, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("Invalid file format");
+        }
+        if (header.version != SPARSE_BINARY_VERSION) {
+            throw std::runtime_error("Unsupported binary format version");
+        }
+        if (header.kind != static_cast<uint32_t>(SparseBinaryKind::CSRMatrix)
+            || header.valueSize != sizeof(T) || header.indexSize != sizeof(uint64_t)) {
+            throw std::runtime_error("Binary file does not match the container type");
+        }
+        
+        rows = header.rows;
+        cols = header.cols;
+        nonZeros = header.nonZeros;
+        
+        size_t end = sparseBinaryPayloadEnd(header);
+        if (end > file.size()) throw std::runtime_error("Unexpected end of binary file");
+        size_t defaultOffset = sparseBinaryAlign(sizeof(header));
+        size_t offset = sparseBinaryArrayEnd(defaultOffset, 1, sizeof(T));
+        size_t rowOffset = sparseBinaryAlign(offset);
+        offset = sparseBinaryArrayEnd(offset, rows + 1, sizeof(uint64_t));
+        size_t colOffset = sparseBinaryAlign(offset);
+        offset = sparseBinaryArrayEnd(offset, nonZeros, sizeof(uint64_t));
+        size_t valueOffset = sparseBinaryAlign(offset);
+        
+        if (verifyChecksum) {
+            uint64_t hash = sparseBinaryChecksum(file.begin() + sizeof(header), end - sizeof(header),
+                                                 sparseBinaryHeaderChecksum(header));
+            if (hash != header.checksum) throw std::runtime_error("Binary file checksum mismatch");
+        }
+        
+        std::memcpy(&defaultValue, file.begin() + defaultOffset, sizeof(T));
+        rowPointers = reinterpret_cast<const size_t*>(file.begin() + rowOffset);
+        colIndices = reinterpret_cast<const size_t*>(file.begin() + colOffset);
+        values = reinterpret_cast<const T*>(file.begin() + valueOffset);
+        
+        if (rowPointers[0] != 0 || rowPointers[rows] != nonZeros
+            || (verifyStructure && !sparseBinaryValidCSR(rowPointers, colIndices, rows, cols, nonZeros))) {
+            throw std::runtime_error("Invalid file format");
+        }
+    }
+    
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+    size_t nonZeroCount() const { return nonZeros; }
+    const T& getDefaultValue() const { return defaultValue; }
+    
+    T get(size_t row, size_t col) const {
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("Matrix index out of range");
+        }
+        const size_t* first = colIndices + rowPointers[row];
+        const size_t* last = colIndices + rowPointers[row + 1];
+        const size_t* it = std::lower_bound(first, last, col);
+        return (it != last && *it == col) ? values[it - colIndices] : defaultValue;
+    }
+    
+    std::vector<T> multiplyVector(const std::vector<T>& vec) const {
+        if (cols != vec.size()) {
+            throw std::invalid_argument("Vector size must match matrix columns");
+        }
+        
+        std::vector<T> result(rows, defaultValue);
+        for (size_t i = 0; i < rows; ++i) {
+            if constexpr (std::is_same<T, double>::value || std::is_same<T, float>::value) {
+                result[i] = defaultValue + simdRowDot(values, colIndices, rowPointers[i], rowPointers[i + 1], vec.data());
+            } else {
+                T sum = defaultValue;
+                for (size_t j = rowPointers[i]; j < rowPointers[i + 1]; ++j) {
+                    sum = sum + values[j] * vec[colIndices[j]];
+                }
+                result[i] = sum;
+            }
+        }
+        
+        return result;
+    }
+    
+    std::string toString() const {
+        std::ostringstream oss;
+        oss << "MappedCSRView[" << rows << "x" << cols << ", stored=" << nonZeros << "]";
+        return oss.str();
+    }
+};
+
+#endif
\ No newline at end of file
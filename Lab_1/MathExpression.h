@@ -1,68 +1,303 @@
 #ifndef MATHEXPRESSION_H
 #define MATHEXPRESSION_H
 
+#include "ExpressionProgram.h"
 #include <string>
 #include <memory>
 #include <cmath>
+#include <cstring>
 #include <sstream>
 #include <map>
+#include <unordered_map>
 #include <vector>
+#include <algorithm>
+#include <utility>
+#include <mutex>
 
 class Cos;
 class Sin;
+class ExpressionFactory;
 
+// Вузли незмінні, тому піддерева можуть бути спільними: вираз — це DAG.
+// Проходи evaluate, differentiate, simplify і compile запам'ятовують результат для кожного
+// вузла, тож спільний підвираз обробляється один раз, а не для кожного шляху до нього
 class MathExpression {
 public:
+    using Cache = std::unordered_map<const MathExpression*, std::shared_ptr<MathExpression>>;
+    using Registers = std::unordered_map<const MathExpression*, uint32_t>;
+    using Values = std::unordered_map<const MathExpression*, double>;
+    
     virtual ~MathExpression() = default;
     
-    virtual double evaluate(double x) const = 0;
     virtual std::string toString() const = 0;
-    virtual std::shared_ptr<MathExpression> derivative() const = 0;
+    
+    // Значення в одній точці обходом вузлів; для багатьох точок швидше compile()
+    double evaluate(double x) const {
+        Values values;
+        return evaluate(x, values);
+    }
+    
+    double evaluate(double x, Values& values) const {
+        auto found = values.find(this);
+        if (found != values.end()) return found->second;
+        double result = evaluateNode(x, values);
+        values.emplace(this, result);
+        return result;
+    }
+    
+    // Структурно рівний вузол з ExpressionFactory; дочірні вузли не копіюються
     virtual std::shared_ptr<MathExpression> clone() const = 0;
+    
+    // Похідна за правилами диференціювання без спрощення
+    std::shared_ptr<MathExpression> differentiate() const {
+        Cache cache;
+        return differentiate(cache);
+    }
+    
+    std::shared_ptr<MathExpression> differentiate(Cache& cache) const {
+        auto found = cache.find(this);
+        if (found != cache.end()) return found->second;
+        std::shared_ptr<MathExpression> result = differentiateNode(cache);
+        cache.emplace(this, result);
+        return result;
+    }
+    
+    // Спрощений еквівалент: згортання констант, x*1, x+0, x^1, зведення подібних
+    // доданків і множників, розгортання вкладених сум і добутків
+    std::shared_ptr<MathExpression> simplify() const {
+        Cache cache;
+        return simplify(cache);
+    }
+    
+    std::shared_ptr<MathExpression> simplify(Cache& cache) const {
+        auto found = cache.find(this);
+        if (found != cache.end()) return found->second;
+        std::shared_ptr<MathExpression> result = simplifyNode(cache);
+        cache.emplace(this, result);
+        return result;
+    }
+    
+    // Спрощення виконується один раз для всієї похідної, а не в кожному вузлі
+    std::shared_ptr<MathExpression> derivative() const {
+        return differentiate()->simplify();
+    }
+    
+    // Дописує обчислення вузла в програму і повертає регістр з його значенням
+    uint32_t emit(ExpressionProgram& program, Registers& registers) const {
+        auto found = registers.find(this);
+        if (found != registers.end()) return found->second;
+        uint32_t result = emitNode(program, registers);
+        registers.emplace(this, result);
+        return result;
+    }
+    
+    ExpressionProgram compile() const {
+        ExpressionProgram program;
+        Registers registers;
+        program.finish(emit(program, registers));
+        return program;
+    }
+    
+    // Обчислення в n точках блоками через одноразово скомпільовану програму;
+    // для багатьох викликів вигідніше зберегти результат compile()
+    void evaluate(const double* xs, double* out, size_t n) const {
+        compile().evaluate(xs, out, n);
+    }
+    
+    // Структурний порядок вузлів від ExpressionFactory: спершу хеш за типом, числом
+    // і хешами дочірніх вузлів, при рівних хешах — рекурсивне порівняння тих самих полів.
+    // Не залежить від адрес і порядку створення, тож задає канонічний порядок доданків
+    // і множників у спрощених виразах. Вузли, створені напряму, мають нульовий хеш
+    static int compareStructure(const MathExpression* a, const MathExpression* b) {
+        while (a != b) {
+            if (a->structureHash != b->structureHash) return a->structureHash < b->structureHash ? -1 : 1;
+            if (a->kind != b->kind) return a->kind < b->kind ? -1 : 1;
+            if (a->bits != b->bits) return a->bits < b->bits ? -1 : 1;
+            if (!a->left || !b->left) return (a->left != nullptr) - (b->left != nullptr);
+            if (int order = compareStructure(a->left, b->left)) return order;
+            if (!a->right || !b->right) return (a->right != nullptr) - (b->right != nullptr);
+            a = a->right;
+            b = b->right;
+        }
+        return 0;
+    }
+    
+protected:
+    virtual std::shared_ptr<MathExpression> differentiateNode(Cache& cache) const = 0;
+    virtual std::shared_ptr<MathExpression> simplifyNode(Cache& cache) const = 0;
+    virtual uint32_t emitNode(ExpressionProgram& program, Registers& registers) const = 0;
+    virtual double evaluateNode(double x, Values& values) const = 0;
+    
+private:
+    uint64_t structureHash = 0;
+    uint8_t kind = 0;
+    uint64_t bits = 0;
+    const MathExpression* left = nullptr;
+    const MathExpression* right = nullptr;
+    
+    friend class ExpressionFactory;
+};
+
+// Хеш-консинг вузлів: структурно рівні вузли (той самий тип, ті самі дочірні вузли
+// за адресою, те саме число) існують в одному екземплярі, тож рівність виразів,
+// побудованих фабрикою, — це рівність вказівників. Таблиця тримає слабкі посилання
+// і чиститься від мертвих записів, коли подвоюється. Потокобезпечна
+class ExpressionFactory {
+public:
+    using Expr = std::shared_ptr<MathExpression>;
+    
+private:
+    enum class Kind : uint8_t { Constant, Variable, Sum, Product, Power, Sin, Cos, Exp, Ln };
+    
+    struct Key {
+        Kind kind;
+        const MathExpression* left;
+        const MathExpression* right;
+        uint64_t bits;
+        
+        bool operator==(const Key& other) const {
+            return kind == other.kind && left == other.left && right == other.right && bits == other.bits;
+        }
+    };
+    
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            uint64_t h = static_cast<uint64_t>(key.kind) * 0x9E3779B97F4A7C15ull;
+            h = (h ^ reinterpret_cast<uintptr_t>(key.left)) * 0xBF58476D1CE4E5B9ull;
+            h = (h ^ reinterpret_cast<uintptr_t>(key.right)) * 0x94D049BB133111EBull;
+            h = (h ^ key.bits) * 0x9E3779B97F4A7C15ull;
+            return static_cast<size_t>(h ^ (h >> 31));
+        }
+    };
+    
+    std::mutex mutex;
+    std::unordered_map<Key, std::weak_ptr<MathExpression>, KeyHash> table;
+    size_t sweepAt = 1024;
+    
+    static uint64_t bitsOf(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+    
+    template<typename Node, typename... Args>
+    Expr intern(const Key& key, Args&&... args) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = table.find(key);
+        if (found != table.end()) {
+            if (Expr existing = found->second.lock()) return existing;
+        }
+        
+        Expr node = std::make_shared<Node>(std::forward<Args>(args)...);
+        node->kind = static_cast<uint8_t>(key.kind);
+        node->bits = key.bits;
+        node->left = key.left;
+        node->right = key.right;
+        uint64_t h = (static_cast<uint64_t>(key.kind) + 1) * 0x9E3779B97F4A7C15ull;
+        h = (h ^ key.bits) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (key.left ? key.left->structureHash : 0)) * 0x94D049BB133111EBull;
+        h = (h ^ (key.right ? key.right->structureHash : 0)) * 0x9E3779B97F4A7C15ull;
+        node->structureHash = h ^ (h >> 31);
+        if (found != table.end()) {
+            found->second = node;
+        } else {
+            table.emplace(key, node);
+        }
+        
+        if (table.size() >= sweepAt) {
+            for (auto it = table.begin(); it != table.end();) {
+                it = it->second.expired() ? table.erase(it) : std::next(it);
+            }
+            sweepAt = std::max<size_t>(1024, table.size() * 2);
+        }
+        return node;
+    }
+    
+public:
+    static ExpressionFactory& shared() {
+        static ExpressionFactory factory;
+        return factory;
+    }
+    
+    Expr constant(double value);
+    Expr variable();
+    Expr sum(const Expr& left, const Expr& right);
+    Expr product(const Expr& left, const Expr& right);
+    Expr power(const Expr& base, double exponent);
+    Expr sin(const Expr& arg);
+    Expr cos(const Expr& arg);
+    Expr exp(const Expr& arg);
+    Expr ln(const Expr& arg);
+    
+    // Кількість записів у таблиці, включно з ще не прибраними мертвими
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return table.size();
+    }
 };
 
 class Constant : public MathExpression {
 private:
     double value;
     
-public:
-    Constant(double v) : value(v) {}
+protected:
+    std::shared_ptr<MathExpression> differentiateNode(Cache&) const override {
+        return ExpressionFactory::shared().constant(0);
+    }
     
-    double evaluate(double x) const override {
+    std::shared_ptr<MathExpression> simplifyNode(Cache&) const override {
+        return clone();
+    }
+    
+    uint32_t emitNode(ExpressionProgram& program, Registers&) const override {
+        return program.emitConstant(value);
+    }
+    
+    double evaluateNode(double, Values&) const override {
         return value;
     }
     
+public:
+    Constant(double v) : value(v) {}
+    
+    double getValue() const { return value; }
+    
     std::string toString() const override {
         std::ostringstream oss;
         oss << value;
         return oss.str();
     }
     
-    std::shared_ptr<MathExpression> derivative() const override {
-        return std::make_shared<Constant>(0);
-    }
-    
     std::shared_ptr<MathExpression> clone() const override {
-        return std::make_shared<Constant>(value);
+        return ExpressionFactory::shared().constant(value);
     }
 };
 
 class Variable : public MathExpression {
-public:
-    double evaluate(double x) const override {
+protected:
+    std::shared_ptr<MathExpression> differentiateNode(Cache&) const override {
+        return ExpressionFactory::shared().constant(1);
+    }
+    
+    std::shared_ptr<MathExpression> simplifyNode(Cache&) const override {
+        return clone();
+    }
+    
+    uint32_t emitNode(ExpressionProgram& program, Registers&) const override {
+        return program.emitVariable();
+    }
+    
+    double evaluateNode(double x, Values&) const override {
         return x;
     }
     
+public:
     std::string toString() const override {
         return "x";
     }
     
-    std::shared_ptr<MathExpression> derivative() const override {
-        return std::make_shared<Constant>(1);
-    }
-    
     std::shared_ptr<MathExpression> clone() const override {
-        return std::make_shared<Variable>();
+        return ExpressionFactory::shared().variable();
     }
 };
 
@@ -71,24 +306,36 @@ private:
     std::shared_ptr<MathExpression> left;
     std::shared_ptr<MathExpression> right;
     
+protected:
+    std::shared_ptr<MathExpression> differentiateNode(Cache& cache) const override {
+        return ExpressionFactory::shared().sum(left->differentiate(cache), right->differentiate(cache));
+    }
+    
+    std::shared_ptr<MathExpression> simplifyNode(Cache& cache) const override;
+    
+    uint32_t emitNode(ExpressionProgram& program, Registers& registers) const override {
+        uint32_t l = left->emit(program, registers);
+        uint32_t r = right->emit(program, registers);
+        return program.emitBinary(OpCode::Add, l, r);
+    }
+    
+    double evaluateNode(double x, Values& values) const override {
+        return left->evaluate(x, values) + right->evaluate(x, values);
+    }
+    
 public:
     Sum(std::shared_ptr<MathExpression> l, std::shared_ptr<MathExpression> r)
         : left(l), right(r) {}
     
-    double evaluate(double x) const override {
-        return left->evaluate(x) + right->evaluate(x);
-    }
+    const std::shared_ptr<MathExpression>& getLeft() const { return left; }
+    const std::shared_ptr<MathExpression>& getRight() const { return right; }
     
     std::string toString() const override {
         return "(" + left->toString() + " + " + right->toString() + ")";
     }
     
-    std::shared_ptr<MathExpression> derivative() const override {
-        return std::make_shared<Sum>(left->derivative(), right->derivative());
-    }
-    
     std::shared_ptr<MathExpression> clone() const override {
-        return std::make_shared<Sum>(left->clone(), right->clone());
+        return ExpressionFactory::shared().sum(left, right);
     }
 };
 
@@ -97,26 +344,39 @@ private:
     std::shared_ptr<MathExpression> left;
     std::shared_ptr<MathExpression> right;
     
+protected:
+    std::shared_ptr<MathExpression> differentiateNode(Cache& cache) const override {
+        ExpressionFactory& factory = ExpressionFactory::shared();
+        std::shared_ptr<MathExpression> term1 = factory.product(left->differentiate(cache), right);
+        std::shared_ptr<MathExpression> term2 = factory.product(left, right->differentiate(cache));
+        return factory.sum(term1, term2);
+    }
+    
+    std::shared_ptr<MathExpression> simplifyNode(Cache& cache) const override;
+    
+    uint32_t emitNode(ExpressionProgram& program, Registers& registers) const override {
+        uint32_t l = left->emit(program, registers);
+        uint32_t r = right->emit(program, registers);
+        return program.emitBinary(OpCode::Mul, l, r);
+    }
+    
+    double evaluateNode(double x, Values& values) const override {
+        return left->evaluate(x, values) * right->evaluate(x, values);
+    }
+    
 public:
     Product(std::shared_ptr<MathExpression> l, std::shared_ptr<MathExpression> r)
         : left(l), right(r) {}
     
-    double evaluate(double x) const override {
-        return left->evaluate(x) * right->evaluate(x);
-    }
+    const std::shared_ptr<MathExpression>& getLeft() const { return left; }
+    const std::shared_ptr<MathExpression>& getRight() const { return right; }
     
     std::string toString() const override {
         return "(" + left->toString() + " * " + right->toString() + ")";
     }
     
-    std::shared_ptr<MathExpression> derivative() const override {
-        std::shared_ptr<MathExpression> term1 = std::make_shared<Product>(left->derivative(), right->clone());
-        std::shared_ptr<MathExpression> term2 = std::make_shared<Product>(left->clone(), right->derivative());
-        return std::make_shared<Sum>(term1, term2);
-    }
-    
     std::shared_ptr<MathExpression> clone() const override {
-        return std::make_shared<Product>(left->clone(), right->clone());
+        return ExpressionFactory::shared().product(left, right);
     }
 };
 
@@ -125,13 +385,46 @@ private:
     std::shared_ptr<MathExpression> base;
     double exponent;
     
+protected:
+    std::shared_ptr<MathExpression> differentiateNode(Cache& cache) const override {
+        ExpressionFactory& factory = ExpressionFactory::shared();
+        std::shared_ptr<MathExpression> coef = factory.constant(exponent);
+        std::shared_ptr<MathExpression> pow = factory.power(base, exponent - 1);
+        std::shared_ptr<MathExpression> prod1 = factory.product(coef, pow);
+        return factory.product(prod1, base->differentiate(cache));
+    }
+    
+    std::shared_ptr<MathExpression> simplifyNode(Cache& cache) const override {
+        ExpressionFactory& factory = ExpressionFactory::shared();
+        std::shared_ptr<MathExpression> b = base->simplify(cache);
+        if (exponent == 0.0) return factory.constant(1.0);
+        if (exponent == 1.0) return b;
+        if (auto c = std::dynamic_pointer_cast<Constant>(b)) {
+            return factory.constant(std::pow(c->getValue(), exponent));
+        }
+        // (b^p)^n = b^(p*n) лише для цілих p і n: інакше, як (x^0.5)^2 при x < 0,
+        // змінюється область визначення
+        auto inner = std::dynamic_pointer_cast<Power>(b);
+        if (inner && exponent == std::floor(exponent) && inner->exponent == std::floor(inner->exponent)) {
+            return factory.power(inner->base, inner->exponent * exponent)->simplify();
+        }
+        return factory.power(b, exponent);
+    }
+    
+    uint32_t emitNode(ExpressionProgram& program, Registers& registers) const override {
+        return program.emitPower(base->emit(program, registers), exponent);
+    }
+    
+    double evaluateNode(double x, Values& values) const override {
+        return std::pow(base->evaluate(x, values), exponent);
+    }
+    
 public:
     Power(std::shared_ptr<MathExpression> b, double exp)
         : base(b), exponent(exp) {}
     
-    double evaluate(double x) const override {
-        return std::pow(base->evaluate(x), exponent);
-    }
+    const std::shared_ptr<MathExpression>& getBase() const { return base; }
+    double getExponent() const { return exponent; }
     
     std::string toString() const override {
         std::ostringstream oss;
@@ -139,15 +432,8 @@ public:
         return oss.str();
     }
     
-    std::shared_ptr<MathExpression> derivative() const override {
-        std::shared_ptr<MathExpression> coef = std::make_shared<Constant>(exponent);
-        std::shared_ptr<MathExpression> pow = std::make_shared<Power>(base->clone(), exponent - 1);
-        std::shared_ptr<MathExpression> prod1 = std::make_shared<Product>(coef, pow);
-        return std::make_shared<Product>(prod1, base->derivative());
-    }
-    
     std::shared_ptr<MathExpression> clone() const override {
-        return std::make_shared<Power>(base->clone(), exponent);
+        return ExpressionFactory::shared().power(base, exponent);
     }
 };
 
@@ -155,21 +441,36 @@ class Cos : public MathExpression {
 private:
     std::shared_ptr<MathExpression> arg;
     
+protected:
+    std::shared_ptr<MathExpression> differentiateNode(Cache& cache) const override;
+    
+    std::shared_ptr<MathExpression> simplifyNode(Cache& cache) const override {
+        std::shared_ptr<MathExpression> a = arg->simplify(cache);
+        if (auto c = std::dynamic_pointer_cast<Constant>(a)) {
+            return ExpressionFactory::shared().constant(std::cos(c->getValue()));
+        }
+        return ExpressionFactory::shared().cos(a);
+    }
+    
+    uint32_t emitNode(ExpressionProgram& program, Registers& registers) const override {
+        return program.emitUnary(OpCode::Cos, arg->emit(program, registers));
+    }
+    
+    double evaluateNode(double x, Values& values) const override {
+        return std::cos(arg->evaluate(x, values));
+    }
+    
 public:
     Cos(std::shared_ptr<MathExpression> a) : arg(a) {}
     
-    double evaluate(double x) const override {
-        return std::cos(arg->evaluate(x));
-    }
+    const std::shared_ptr<MathExpression>& getArgument() const { return arg; }
     
     std::string toString() const override {
         return "cos(" + arg->toString() + ")";
     }
     
-    std::shared_ptr<MathExpression> derivative() const override;
-    
     std::shared_ptr<MathExpression> clone() const override {
-        return std::make_shared<Cos>(arg->clone());
+        return ExpressionFactory::shared().cos(arg);
     }
 };
 
@@ -177,57 +478,88 @@ class Sin : public MathExpression {
 private:
     std::shared_ptr<MathExpression> arg;
     
+protected:
+    std::shared_ptr<MathExpression> differentiateNode(Cache& cache) const override {
+        ExpressionFactory& factory = ExpressionFactory::shared();
+        return factory.product(factory.cos(arg), arg->differentiate(cache));
+    }
+    
+    std::shared_ptr<MathExpression> simplifyNode(Cache& cache) const override {
+        std::shared_ptr<MathExpression> a = arg->simplify(cache);
+        if (auto c = std::dynamic_pointer_cast<Constant>(a)) {
+            return ExpressionFactory::shared().constant(std::sin(c->getValue()));
+        }
+        return ExpressionFactory::shared().sin(a);
+    }
+    
+    uint32_t emitNode(ExpressionProgram& program, Registers& registers) const override {
+        return program.emitUnary(OpCode::Sin, arg->emit(program, registers));
+    }
+    
+    double evaluateNode(double x, Values& values) const override {
+        return std::sin(arg->evaluate(x, values));
+    }
+    
 public:
     Sin(std::shared_ptr<MathExpression> a) : arg(a) {}
     
-    double evaluate(double x) const override {
-        return std::sin(arg->evaluate(x));
-    }
+    const std::shared_ptr<MathExpression>& getArgument() const { return arg; }
     
     std::string toString() const override {
         return "sin(" + arg->toString() + ")";
     }
     
-    std::shared_ptr<MathExpression> derivative() const override {
-        std::shared_ptr<MathExpression> cosExpr = std::make_shared<Cos>(arg->clone());
-        return std::make_shared<Product>(cosExpr, arg->derivative());
-    }
-    
     std::shared_ptr<MathExpression> clone() const override {
-        return std::make_shared<Sin>(arg->clone());
+        return ExpressionFactory::shared().sin(arg);
     }
 };
 
 // Реалізація похідної косинуса (після оголошення Sin)
-inline std::shared_ptr<MathExpression> Cos::derivative() const {
-    std::shared_ptr<MathExpression> minusOne = std::make_shared<Constant>(-1);
-    std::shared_ptr<MathExpression> sinExpr = std::make_shared<Sin>(arg->clone());
-    std::shared_ptr<MathExpression> prod = std::make_shared<Product>(minusOne, sinExpr);
-    return std::make_shared<Product>(prod, arg->derivative());
+inline std::shared_ptr<MathExpression> Cos::differentiateNode(Cache& cache) const {
+    ExpressionFactory& factory = ExpressionFactory::shared();
+    std::shared_ptr<MathExpression> minusOne = factory.constant(-1);
+    std::shared_ptr<MathExpression> sinExpr = factory.sin(arg);
+    std::shared_ptr<MathExpression> prod = factory.product(minusOne, sinExpr);
+    return factory.product(prod, arg->differentiate(cache));
 }
 
 class Exp : public MathExpression {
 private:
     std::shared_ptr<MathExpression> arg;
     
+protected:
+    std::shared_ptr<MathExpression> differentiateNode(Cache& cache) const override {
+        ExpressionFactory& factory = ExpressionFactory::shared();
+        return factory.product(factory.exp(arg), arg->differentiate(cache));
+    }
+    
+    std::shared_ptr<MathExpression> simplifyNode(Cache& cache) const override {
+        std::shared_ptr<MathExpression> a = arg->simplify(cache);
+        if (auto c = std::dynamic_pointer_cast<Constant>(a)) {
+            return ExpressionFactory::shared().constant(std::exp(c->getValue()));
+        }
+        return ExpressionFactory::shared().exp(a);
+    }
+    
+    uint32_t emitNode(ExpressionProgram& program, Registers& registers) const override {
+        return program.emitUnary(OpCode::Exp, arg->emit(program, registers));
+    }
+    
+    double evaluateNode(double x, Values& values) const override {
+        return std::exp(arg->evaluate(x, values));
+    }
+    
 public:
     Exp(std::shared_ptr<MathExpression> a) : arg(a) {}
     
-    double evaluate(double x) const override {
-        return std::exp(arg->evaluate(x));
-    }
+    const std::shared_ptr<MathExpression>& getArgument() const { return arg; }
     
     std::string toString() const override {
         return "exp(" + arg->toString() + ")";
     }
     
-    std::shared_ptr<MathExpression> derivative() const override {
-        std::shared_ptr<MathExpression> expExpr = std::make_shared<Exp>(arg->clone());
-        return std::make_shared<Product>(expExpr, arg->derivative());
-    }
-    
     std::shared_ptr<MathExpression> clone() const override {
-        return std::make_shared<Exp>(arg->clone());
+        return ExpressionFactory::shared().exp(arg);
     }
 };
 
@@ -235,25 +567,255 @@ class Ln : public MathExpression {
 private:
     std::shared_ptr<MathExpression> arg;
     
+protected:
+    std::shared_ptr<MathExpression> differentiateNode(Cache& cache) const override {
+        ExpressionFactory& factory = ExpressionFactory::shared();
+        std::shared_ptr<MathExpression> invArg = factory.power(arg, -1);
+        return factory.product(arg->differentiate(cache), invArg);
+    }
+    
+    std::shared_ptr<MathExpression> simplifyNode(Cache& cache) const override {
+        std::shared_ptr<MathExpression> a = arg->simplify(cache);
+        if (auto c = std::dynamic_pointer_cast<Constant>(a)) {
+            return ExpressionFactory::shared().constant(std::log(c->getValue()));
+        }
+        return ExpressionFactory::shared().ln(a);
+    }
+    
+    uint32_t emitNode(ExpressionProgram& program, Registers& registers) const override {
+        return program.emitUnary(OpCode::Ln, arg->emit(program, registers));
+    }
+    
+    double evaluateNode(double x, Values& values) const override {
+        return std::log(arg->evaluate(x, values));
+    }
+    
 public:
     Ln(std::shared_ptr<MathExpression> a) : arg(a) {}
     
-    double evaluate(double x) const override {
-        return std::log(arg->evaluate(x));
-    }
+    const std::shared_ptr<MathExpression>& getArgument() const { return arg; }
     
     std::string toString() const override {
         return "ln(" + arg->toString() + ")";
     }
     
-    std::shared_ptr<MathExpression> derivative() const override {
-        std::shared_ptr<MathExpression> invArg = std::make_shared<Power>(arg->clone(), -1);
-        return std::make_shared<Product>(arg->derivative(), invArg);
-    }
-    
     std::shared_ptr<MathExpression> clone() const override {
-        return std::make_shared<Ln>(arg->clone());
+        return ExpressionFactory::shared().ln(arg);
     }
 };
 
+// Методи фабрики (після оголошення всіх вузлів)
+inline ExpressionFactory::Expr ExpressionFactory::constant(double value) {
+    return intern<Constant>(Key{Kind::Constant, nullptr, nullptr, bitsOf(value)}, value);
+}
+
+inline ExpressionFactory::Expr ExpressionFactory::variable() {
+    return intern<Variable>(Key{Kind::Variable, nullptr, nullptr, 0});
+}
+
+inline ExpressionFactory::Expr ExpressionFactory::sum(const Expr& left, const Expr& right) {
+    return intern<Sum>(Key{Kind::Sum, left.get(), right.get(), 0}, left, right);
+}
+
+inline ExpressionFactory::Expr ExpressionFactory::product(const Expr& left, const Expr& right) {
+    return intern<Product>(Key{Kind::Product, left.get(), right.get(), 0}, left, right);
+}
+
+inline ExpressionFactory::Expr ExpressionFactory::power(const Expr& base, double exponent) {
+    return intern<Power>(Key{Kind::Power, base.get(), nullptr, bitsOf(exponent)}, base, exponent);
+}
+
+inline ExpressionFactory::Expr ExpressionFactory::sin(const Expr& arg) {
+    return intern<Sin>(Key{Kind::Sin, arg.get(), nullptr, 0}, arg);
+}
+
+inline ExpressionFactory::Expr ExpressionFactory::cos(const Expr& arg) {
+    return intern<Cos>(Key{Kind::Cos, arg.get(), nullptr, 0}, arg);
+}
+
+inline ExpressionFactory::Expr ExpressionFactory::exp(const Expr& arg) {
+    return intern<Exp>(Key{Kind::Exp, arg.get(), nullptr, 0}, arg);
+}
+
+inline ExpressionFactory::Expr ExpressionFactory::ln(const Expr& arg) {
+    return intern<Ln>(Key{Kind::Ln, arg.get(), nullptr, 0}, arg);
+}
+
+// Спрощення сум і добутків (після оголошення всіх вузлів).
+// Результат спрощення будує фабрика, тож однакові підвирази — це той самий вузол
+// і подібні доданки й множники шукаються за вказівником. Суми й добутки зберігаються
+// правим ланцюжком a + (b + (c + ...)), упорядкованим структурно (compareStructure),
+// а числовий коефіцієнт добутку стоїть першим
+namespace simplification {
+    using Expr = std::shared_ptr<MathExpression>;
+    
+    inline void collectTerms(const Expr& e, std::vector<Expr>& terms) {
+        if (auto sum = std::dynamic_pointer_cast<Sum>(e)) {
+            collectTerms(sum->getLeft(), terms);
+            collectTerms(sum->getRight(), terms);
+        } else {
+            terms.push_back(e);
+        }
+    }
+    
+    inline void collectFactors(const Expr& e, std::vector<Expr>& factors) {
+        if (auto product = std::dynamic_pointer_cast<Product>(e)) {
+            collectFactors(product->getLeft(), factors);
+            collectFactors(product->getRight(), factors);
+        } else {
+            factors.push_back(e);
+        }
+    }
+    
+    // b^p * b^q = b^(p+q) зберігає область визначення лише для цілих показників
+    // одного знаку: x^0.5 * x^0.5 не визначено при x < 0, а x * x^-1 — при x = 0
+    inline bool mergeableExponents(double p, double q) {
+        return p == std::floor(p) && q == std::floor(q) && (p > 0) == (q > 0);
+    }
+    
+    inline Expr chainSum(const std::vector<Expr>& items) {
+        Expr result = items.back();
+        for (size_t i = items.size() - 1; i-- > 0;) {
+            result = ExpressionFactory::shared().sum(items[i], result);
+        }
+        return result;
+    }
+    
+    inline Expr chainProduct(const std::vector<Expr>& items) {
+        Expr result = items.back();
+        for (size_t i = items.size() - 1; i-- > 0;) {
+            result = ExpressionFactory::shared().product(items[i], result);
+        }
+        return result;
+    }
+    
+    // Пари (ключовий вузол, вираз), відсортовані структурно за ключовим вузлом;
+    // однакові ключі (незведені степені однієї основи) лишаються в початковому порядку
+    inline std::vector<Expr> ordered(std::vector<std::pair<Expr, Expr>>& keyed) {
+        std::stable_sort(keyed.begin(), keyed.end(),
+            [](const std::pair<Expr, Expr>& a, const std::pair<Expr, Expr>& b) {
+                return MathExpression::compareStructure(a.first.get(), b.first.get()) < 0;
+            });
+        std::vector<Expr> result;
+        for (auto& item : keyed) result.push_back(item.second);
+        return result;
+    }
+}
+
+inline std::shared_ptr<MathExpression> Sum::simplifyNode(Cache& cache) const {
+    using namespace simplification;
+    ExpressionFactory& factory = ExpressionFactory::shared();
+    std::vector<Expr> terms;
+    collectTerms(left->simplify(cache), terms);
+    collectTerms(right->simplify(cache), terms);
+    
+    // Доданок c * rest зводиться з іншими доданками з тим самим rest
+    double constant = 0.0;
+    std::vector<std::pair<Expr, double>> like;
+    std::unordered_map<const MathExpression*, size_t> position;
+    for (const Expr& term : terms) {
+        if (auto c = std::dynamic_pointer_cast<Constant>(term)) {
+            constant += c->getValue();
+            continue;
+        }
+        Expr rest = term;
+        double coefficient = 1.0;
+        auto product = std::dynamic_pointer_cast<Product>(term);
+        if (product) {
+            if (auto c = std::dynamic_pointer_cast<Constant>(product->getLeft())) {
+                coefficient = c->getValue();
+                rest = product->getRight();
+            }
+        }
+        auto inserted = position.emplace(rest.get(), like.size());
+        if (inserted.second) {
+            like.emplace_back(rest, coefficient);
+        } else {
+            like[inserted.first->second].second += coefficient;
+        }
+    }
+    
+    std::vector<std::pair<Expr, Expr>> keyed;
+    for (auto& item : like) {
+        double coefficient = item.second;
+        if (coefficient == 0.0) continue;
+        Expr term = item.first;
+        if (coefficient != 1.0) {
+            term = factory.product(factory.constant(coefficient), term)->simplify();
+        }
+        keyed.emplace_back(item.first, term);
+    }
+    std::vector<Expr> result = ordered(keyed);
+    if (constant != 0.0 || result.empty()) result.push_back(factory.constant(constant));
+    return chainSum(result);
+}
+
+inline std::shared_ptr<MathExpression> Product::simplifyNode(Cache& cache) const {
+    using namespace simplification;
+    ExpressionFactory& factory = ExpressionFactory::shared();
+    std::vector<Expr> factors;
+    collectFactors(left->simplify(cache), factors);
+    collectFactors(right->simplify(cache), factors);
+    
+    // Множник b^p зводиться з попереднім множником з тією самою основою b,
+    // якщо це не змінює області визначення
+    double coefficient = 1.0;
+    std::vector<std::pair<Expr, double>> powers;
+    std::unordered_map<const MathExpression*, size_t> position;
+    for (const Expr& factor : factors) {
+        if (auto c = std::dynamic_pointer_cast<Constant>(factor)) {
+            coefficient *= c->getValue();
+            continue;
+        }
+        Expr base = factor;
+        double exponent = 1.0;
+        if (auto power = std::dynamic_pointer_cast<Power>(factor)) {
+            base = power->getBase();
+            exponent = power->getExponent();
+        }
+        auto found = position.find(base.get());
+        if (found != position.end() && mergeableExponents(powers[found->second].second, exponent)) {
+            powers[found->second].second += exponent;
+        } else {
+            position[base.get()] = powers.size();
+            powers.emplace_back(base, exponent);
+        }
+    }
+    if (coefficient == 0.0) return factory.constant(0.0);
+    
+    std::vector<std::pair<Expr, Expr>> keyed;
+    for (auto& item : powers) {
+        double exponent = item.second;
+        if (exponent == 0.0) continue;
+        Expr factor = item.first;
+        if (exponent != 1.0) factor = factory.power(factor, exponent);
+        keyed.emplace_back(item.first, factor);
+    }
+    std::vector<Expr> result = ordered(keyed);
+    if (coefficient != 1.0 || result.empty()) {
+        result.insert(result.begin(), factory.constant(coefficient));
+    }
+    
+    // Якщо серед множників рівно одна сума, решта розкривається в неї: вираз росте
+    // лише лінійно, а подібні доданки з різних рівнів вкладеності стають видимими
+    size_t sums = 0, sumPosition = 0;
+    for (size_t i = 0; i < result.size(); ++i) {
+        if (std::dynamic_pointer_cast<Sum>(result[i])) {
+            ++sums;
+            sumPosition = i;
+        }
+    }
+    if (sums == 1 && result.size() > 1) {
+        std::vector<Expr> terms;
+        collectTerms(result[sumPosition], terms);
+        for (Expr& term : terms) {
+            std::vector<Expr> others = result;
+            others[sumPosition] = term;
+            term = chainProduct(others);
+        }
+        return chainSum(terms)->simplify();
+    }
+    return chainProduct(result);
+}
+
 #endif
\ No newline at end of file
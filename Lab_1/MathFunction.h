@@ -4,18 +4,61 @@
 #include "MathExpression.h"
 #include <vector>
 #include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
 
+// Вираз компілюється в плоску програму один раз при створенні; усі обчислення
+// (інтегрування, табуляція, пошук кореня) йдуть через неї, а не через дерево
 class MathFunction {
 private:
     std::shared_ptr<MathExpression> expression;
     std::string name;
+    ExpressionProgram program;
+    
+    // Коефіцієнти через послідовні символьні похідні (запасний шлях taylorSeries)
+    std::vector<double> symbolicTaylorSeries(double point, int terms) const {
+        std::vector<double> coefficients;
+        MathFunction current(expression, name);
+        double factorial = 1.0;
+        
+        for (int i = 0; i < terms; ++i) {
+            if (i > 0) factorial *= i;
+            coefficients.push_back(current.evaluate(point) / factorial);
+            
+            if (i < terms - 1) {
+                current = current.derivative();
+            }
+        }
+        
+        return coefficients;
+    }
     
 public:
     MathFunction(std::shared_ptr<MathExpression> expr, const std::string& n = "f")
-        : expression(expr), name(n) {}
+        : expression(expr), name(n), program(expr->compile()) {}
     
     double evaluate(double x) const {
-        return expression->evaluate(x);
+        return program.evaluate(x);
+    }
+    
+    void evaluate(const double* xs, double* out, size_t n) const {
+        program.evaluate(xs, out, n);
+    }
+    
+    std::vector<double> evaluate(const std::vector<double>& xs) const {
+        std::vector<double> result(xs.size());
+        program.evaluate(xs.data(), result.data(), xs.size());
+        return result;
+    }
+    
+    // Значення і перша похідна без побудови дерева похідної
+    double evaluateWithDerivative(double x, double& derivative) const {
+        return program.evaluateWithDerivative(x, derivative);
+    }
+    
+    const ExpressionProgram& getProgram() const {
+        return program;
     }
     
     std::string toString() const {
@@ -47,8 +90,18 @@ public:
         double h = (b - a) / steps;
         double sum = 0.5 * (evaluate(a) + evaluate(b));
         
-        for (int i = 1; i < steps; ++i) {
-            sum += evaluate(a + i * h);
+        // Внутрішні вузли обчислюються пачками, порядок додавання той самий
+        const int chunk = 1024;
+        std::vector<double> points(std::min(chunk, steps));
+        for (int first = 1; first < steps; first += chunk) {
+            int count = std::min(chunk, steps - first);
+            for (int i = 0; i < count; ++i) {
+                points[i] = a + (first + i) * h;
+            }
+            evaluate(points.data(), points.data(), count);
+            for (int i = 0; i < count; ++i) {
+                sum += points[i];
+            }
         }
         
         return sum * h;
@@ -58,22 +111,16 @@ public:
         return evaluate(point + epsilon);
     }
     
+    // Усі коефіцієнти за один прохід програми в арифметиці обрізаних рядів Тейлора.
+    // Якщо в точці основа степеня, логарифма чи дробу дорівнює нулю, рекурентні
+    // формули не працюють, і коефіцієнти рахуються через символьні похідні
     std::vector<double> taylorSeries(double point, int terms) const {
-        std::vector<double> coefficients;
-        MathFunction current(expression->clone(), name);
-        double factorial = 1.0;
-        
-        for (int i = 0; i < terms; ++i) {
-            if (i > 0) factorial *= i;
-            double coef = current.evaluate(point) / factorial;
-            coefficients.push_back(coef);
-            
-            if (i < terms - 1) {
-                current = current.derivative();
-            }
+        if (terms <= 0) return std::vector<double>();
+        try {
+            return program.taylor(point, static_cast<size_t>(terms - 1));
+        } catch (const std::domain_error&) {
+            return symbolicTaylorSeries(point, terms);
         }
-        
-        return coefficients;
     }
     
     double seriesSum(int start, int end, std::function<double(int)> termFunction) const {
@@ -85,12 +132,11 @@ public:
     }
     
     double findRoot(double initialGuess, double tolerance = 1e-6, int maxIterations = 100) const {
-        auto deriv = derivative();
         double x = initialGuess;
         
         for (int i = 0; i < maxIterations; ++i) {
-            double fx = evaluate(x);
-            double dfx = deriv.evaluate(x);
+            double dfx;
+            double fx = evaluateWithDerivative(x, dfx);
             
             if (std::abs(dfx) < tolerance) {
                 throw std::runtime_error("Derivative too small");
@@ -112,9 +158,15 @@ public:
         std::vector<std::pair<double, double>> result;
         double step = (end - start) / (points - 1);
         
+        std::vector<double> xs;
         for (int i = 0; i < points; ++i) {
-            double x = start + i * step;
-            result.push_back({x, evaluate(x)});
+            xs.push_back(start + i * step);
+        }
+        std::vector<double> ys = evaluate(xs);
+        
+        result.reserve(xs.size());
+        for (size_t i = 0; i < xs.size(); ++i) {
+            result.push_back({xs[i], ys[i]});
         }
         
         return result;
@@ -0,0 +1,105 @@
+#ifndef SELLCSIGMAMATRIX_H
+#define SELLCSIGMAMATRIX_H
+
+#include "SparseMatrix.h"
+#include <vector>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+
+// SELL-C-σ (sliced ELLPACK): рядки сортуються за довжиною у вікнах по sigma рядків,
+// групуються у зрізи по C рядків і зберігаються по стовпцях зрізу з доповненням до
+// найдовшого рядка. Зріз множиться ядром simdSliceDot: gather іде по C сусідніх рядках,
+// тож векторизується навіть для коротких рядків, а довжини рядків маскують доповнення.
+// Формат лише для читання і призначений для SpMV
+template<typename T, size_t C = 8>
+class SellCSigmaMatrix {
+private:
+    size_t rows, cols;
+    size_t nonZeros;
+    T defaultValue;
+    std::vector<T> values;
+    std::vector<size_t> colIndices;
+    std::vector<size_t> sliceOffsets;
+    std::vector<size_t> sliceWidths;
+    std::vector<size_t> rowLengths;
+    std::vector<size_t> permutation;
+    
+public:
+    explicit SellCSigmaMatrix(const CSRSparseMatrix<T>& csr, size_t sigma = 256)
+        : rows(csr.getRows()), cols(csr.getCols()), nonZeros(csr.nonZeroCount()),
+          defaultValue(csr.getDefaultValue()) {
+        if (sigma < C) sigma = C;
+        const std::vector<size_t>& rowPointers = csr.getRowPointers();
+        const std::vector<size_t>& csrCols = csr.getColIndices();
+        const std::vector<T>& csrValues = csr.getValues();
+        
+        auto rowLength = [&](size_t r) { return rowPointers[r + 1] - rowPointers[r]; };
+        
+        permutation.resize(rows);
+        std::iota(permutation.begin(), permutation.end(), size_t(0));
+        for (size_t begin = 0; begin < rows; begin += sigma) {
+            size_t end = std::min(rows, begin + sigma);
+            std::stable_sort(permutation.begin() + begin, permutation.begin() + end,
+                [&](size_t a, size_t b) { return rowLength(a) > rowLength(b); });
+        }
+        
+        size_t slices = (rows + C - 1) / C;
+        sliceOffsets.resize(slices + 1, 0);
+        sliceWidths.resize(slices, 0);
+        for (size_t s = 0; s < slices; ++s) {
+            for (size_t r = s * C; r < std::min(rows, (s + 1) * C); ++r) {
+                sliceWidths[s] = std::max(sliceWidths[s], rowLength(permutation[r]));
+            }
+            sliceOffsets[s + 1] = sliceOffsets[s] + sliceWidths[s] * C;
+        }
+        
+        values.assign(sliceOffsets[slices], T());
+        colIndices.assign(sliceOffsets[slices], 0);
+        rowLengths.assign(slices * C, 0);
+        for (size_t s = 0; s < slices; ++s) {
+            for (size_t lane = 0; lane < C && s * C + lane < rows; ++lane) {
+                size_t row = permutation[s * C + lane];
+                rowLengths[s * C + lane] = rowLength(row);
+                size_t k = 0;
+                for (size_t j = rowPointers[row]; j < rowPointers[row + 1]; ++j, ++k) {
+                    values[sliceOffsets[s] + k * C + lane] = csrValues[j];
+                    colIndices[sliceOffsets[s] + k * C + lane] = csrCols[j];
+                }
+            }
+        }
+    }
+    
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+    size_t nonZeroCount() const { return nonZeros; }
+    size_t storedCount() const { return values.size(); }
+    
+    std::vector<T> multiplyVector(const std::vector<T>& vec) const {
+        if (cols != vec.size()) {
+            throw std::invalid_argument("Vector size must match matrix columns");
+        }
+        
+        std::vector<T> result(rows, defaultValue);
+        T lanes[C];
+        for (size_t s = 0; s < sliceWidths.size(); ++s) {
+            simdSliceDot(values.data() + sliceOffsets[s], colIndices.data() + sliceOffsets[s],
+                         rowLengths.data() + s * C, C, vec.data(), lanes);
+            for (size_t lane = 0; lane < C && s * C + lane < rows; ++lane) {
+                result[permutation[s * C + lane]] = defaultValue + lanes[lane];
+            }
+        }
+        
+        return result;
+    }
+    
+    std::string toString() const {
+        std::ostringstream oss;
+        oss << "SellCSigmaMatrix[" << rows << "x" << cols << ", C=" << C
+            << ", stored=" << nonZeros << ", padded=" << values.size() << "]";
+        return oss.str();
+    }
+};
+
+#endif
\ No newline at end of file
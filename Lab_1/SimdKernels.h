@@ -0,0 +1,327 @@
+#ifndef SIMDKERNELS_H
+#define SIMDKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define SPARSE_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// Скалярний добуток рядка CSR на вектор: sum(values[j] * x[cols[j]]) для j з [begin, end).
+// Для double/float на x86 вибирається AVX-512 або AVX2 ядро з gather під час виконання;
+// порядок додавання в векторних ядрах інший, ніж у скалярному циклі.
+// Індекси бувають 64- або 32-бітні; 32-бітний gather знаковий, тому такі ядра
+// придатні лише для матриць із cols <= 2^31 (див. simdGatherFits)
+enum class SimdLevel { Scalar, AVX2, AVX512 };
+
+template<typename T, typename Index>
+inline T scalarRowDot(const T* values, const Index* cols, size_t begin, size_t end, const T* x) {
+    T sum = T();
+    for (size_t j = begin; j < end; ++j) {
+        sum = sum + values[j] * x[cols[j]];
+    }
+    return sum;
+}
+
+// Зріз SELL-C-σ: values і cols зберігаються по стовпцях зрізу (елемент k рядка lane
+// лежить у k * lanes + lane), acc[lane] — добуток рядка lane на x. Береться лише
+// lengths[lane] елементів рядка, тож доповнення не читає x і не переносить у рядок
+// inf чи NaN з x[0]. Кожна доріжка додає свої елементи в тому ж порядку, що й scalarRowDot
+template<typename T>
+inline void scalarSliceDot(const T* values, const size_t* cols, const size_t* lengths, size_t lanes,
+                           const T* x, T* acc) {
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        T sum = T();
+        for (size_t k = 0; k < lengths[lane]; ++k) {
+            sum = sum + values[k * lanes + lane] * x[cols[k * lanes + lane]];
+        }
+        acc[lane] = sum;
+    }
+}
+
+#ifdef SPARSE_SIMD_X86
+
+__attribute__((target("avx2")))
+inline double avx2RowDot(const double* values, const size_t* cols, size_t begin, size_t end, const double* x) {
+    __m256d acc = _mm256_setzero_pd();
+    size_t j = begin;
+    for (; j + 4 <= end; j += 4) {
+        __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols + j));
+        __m256d xs = _mm256_i64gather_pd(x, idx, 8);
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_loadu_pd(values + j), xs));
+    }
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    double sum = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+    for (; j < end; ++j) {
+        sum += values[j] * x[cols[j]];
+    }
+    return sum;
+}
+
+__attribute__((target("avx2")))
+inline float avx2RowDot(const float* values, const size_t* cols, size_t begin, size_t end, const float* x) {
+    __m128 acc = _mm_setzero_ps();
+    size_t j = begin;
+    for (; j + 4 <= end; j += 4) {
+        __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols + j));
+        __m128 xs = _mm256_i64gather_ps(x, idx, 4);
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(values + j), xs));
+    }
+    __m128 pairs = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    float sum = _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+    for (; j < end; ++j) {
+        sum += values[j] * x[cols[j]];
+    }
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+inline double avx512RowDot(const double* values, const size_t* cols, size_t begin, size_t end, const double* x) {
+    __m512d acc = _mm512_setzero_pd();
+    size_t j = begin;
+    for (; j + 8 <= end; j += 8) {
+        __m512i idx = _mm512_loadu_si512(cols + j);
+        __m512d xs = _mm512_mask_i64gather_pd(_mm512_setzero_pd(), 0xFF, idx, x, 8);
+        acc = _mm512_add_pd(acc, _mm512_mul_pd(_mm512_loadu_pd(values + j), xs));
+    }
+    double lanes[8];
+    _mm512_storeu_pd(lanes, acc);
+    double sum = ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) + ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+    for (; j < end; ++j) {
+        sum += values[j] * x[cols[j]];
+    }
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+inline float avx512RowDot(const float* values, const size_t* cols, size_t begin, size_t end, const float* x) {
+    __m256 acc = _mm256_setzero_ps();
+    size_t j = begin;
+    for (; j + 8 <= end; j += 8) {
+        __m512i idx = _mm512_loadu_si512(cols + j);
+        __m256 xs = _mm512_mask_i64gather_ps(_mm256_setzero_ps(), 0xFF, idx, x, 4);
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(values + j), xs));
+    }
+    __m128 quad = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    __m128 pairs = _mm_add_ps(quad, _mm_movehl_ps(quad, quad));
+    float sum = _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+    for (; j < end; ++j) {
+        sum += values[j] * x[cols[j]];
+    }
+    return sum;
+}
+
+__attribute__((target("avx2")))
+inline double avx2RowDot(const double* values, const uint32_t* cols, size_t begin, size_t end, const double* x) {
+    __m256d acc = _mm256_setzero_pd();
+    size_t j = begin;
+    for (; j + 4 <= end; j += 4) {
+        __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cols + j));
+        __m256d xs = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, idx,
+                                               _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_loadu_pd(values + j), xs));
+    }
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    double sum = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+    for (; j < end; ++j) {
+        sum += values[j] * x[cols[j]];
+    }
+    return sum;
+}
+
+__attribute__((target("avx2")))
+inline float avx2RowDot(const float* values, const uint32_t* cols, size_t begin, size_t end, const float* x) {
+    __m256 acc = _mm256_setzero_ps();
+    size_t j = begin;
+    for (; j + 8 <= end; j += 8) {
+        __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols + j));
+        __m256 xs = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), x, idx,
+                                              _mm256_castsi256_ps(_mm256_set1_epi32(-1)), 4);
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(values + j), xs));
+    }
+    __m128 quad = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    __m128 pairs = _mm_add_ps(quad, _mm_movehl_ps(quad, quad));
+    float sum = _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+    for (; j < end; ++j) {
+        sum += values[j] * x[cols[j]];
+    }
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+inline double avx512RowDot(const double* values, const uint32_t* cols, size_t begin, size_t end, const double* x) {
+    __m512d acc = _mm512_setzero_pd();
+    size_t j = begin;
+    for (; j + 8 <= end; j += 8) {
+        __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols + j));
+        __m512d xs = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, idx, x, 8);
+        acc = _mm512_add_pd(acc, _mm512_mul_pd(_mm512_loadu_pd(values + j), xs));
+    }
+    double lanes[8];
+    _mm512_storeu_pd(lanes, acc);
+    double sum = ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6])) + ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+    for (; j < end; ++j) {
+        sum += values[j] * x[cols[j]];
+    }
+    return sum;
+}
+
+__attribute__((target("avx512f")))
+inline float avx512RowDot(const float* values, const uint32_t* cols, size_t begin, size_t end, const float* x) {
+    __m512 acc = _mm512_setzero_ps();
+    size_t j = begin;
+    for (; j + 16 <= end; j += 16) {
+        __m512i idx = _mm512_loadu_si512(cols + j);
+        __m512 xs = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, idx, x, 4);
+        acc = _mm512_add_ps(acc, _mm512_mul_ps(_mm512_loadu_ps(values + j), xs));
+    }
+    float lanes[16];
+    _mm512_storeu_ps(lanes, acc);
+    float sum = 0.0f;
+    for (float lane : lanes) sum += lane;
+    for (; j < end; ++j) {
+        sum += values[j] * x[cols[j]];
+    }
+    return sum;
+}
+
+// Ядра зрізу обробляють групи по 4 (AVX2) або 8 (AVX-512) сусідніх рядків; у доріжки
+// рядків, що вже закінчилися, gather за маскою кладе нуль, а доповнення values теж нульове
+inline size_t sliceGroupWidth(const size_t* lengths, size_t count) {
+    size_t width = 0;
+    for (size_t lane = 0; lane < count; ++lane) width = lengths[lane] > width ? lengths[lane] : width;
+    return width;
+}
+
+__attribute__((target("avx2")))
+inline void avx2SliceDot(const double* values, const size_t* cols, const size_t* lengths, size_t lanes,
+                         const double* x, double* acc) {
+    for (size_t g = 0; g < lanes; g += 4) {
+        __m256i len = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lengths + g));
+        __m256d sum = _mm256_setzero_pd();
+        size_t width = sliceGroupWidth(lengths + g, 4);
+        for (size_t k = 0; k < width; ++k) {
+            __m256d mask = _mm256_castsi256_pd(_mm256_cmpgt_epi64(len, _mm256_set1_epi64x(static_cast<long long>(k))));
+            __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols + k * lanes + g));
+            __m256d xs = _mm256_mask_i64gather_pd(_mm256_setzero_pd(), x, idx, mask, 8);
+            sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_loadu_pd(values + k * lanes + g), xs));
+        }
+        _mm256_storeu_pd(acc + g, sum);
+    }
+}
+
+__attribute__((target("avx2")))
+inline void avx2SliceDot(const float* values, const size_t* cols, const size_t* lengths, size_t lanes,
+                         const float* x, float* acc) {
+    const __m256i low = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    for (size_t g = 0; g < lanes; g += 4) {
+        __m256i len = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lengths + g));
+        __m128 sum = _mm_setzero_ps();
+        size_t width = sliceGroupWidth(lengths + g, 4);
+        for (size_t k = 0; k < width; ++k) {
+            __m256i wide = _mm256_cmpgt_epi64(len, _mm256_set1_epi64x(static_cast<long long>(k)));
+            __m128 mask = _mm_castsi128_ps(_mm256_castsi256_si128(_mm256_permutevar8x32_epi32(wide, low)));
+            __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols + k * lanes + g));
+            __m128 xs = _mm256_mask_i64gather_ps(_mm_setzero_ps(), x, idx, mask, 4);
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(values + k * lanes + g), xs));
+        }
+        _mm_storeu_ps(acc + g, sum);
+    }
+}
+
+__attribute__((target("avx512f")))
+inline void avx512SliceDot(const double* values, const size_t* cols, const size_t* lengths, size_t lanes,
+                           const double* x, double* acc) {
+    for (size_t g = 0; g < lanes; g += 8) {
+        __m512i len = _mm512_loadu_si512(lengths + g);
+        __m512d sum = _mm512_setzero_pd();
+        size_t width = sliceGroupWidth(lengths + g, 8);
+        for (size_t k = 0; k < width; ++k) {
+            __mmask8 mask = _mm512_cmpgt_epu64_mask(len, _mm512_set1_epi64(static_cast<long long>(k)));
+            __m512i idx = _mm512_loadu_si512(cols + k * lanes + g);
+            __m512d xs = _mm512_mask_i64gather_pd(_mm512_setzero_pd(), mask, idx, x, 8);
+            sum = _mm512_add_pd(sum, _mm512_mul_pd(_mm512_loadu_pd(values + k * lanes + g), xs));
+        }
+        _mm512_storeu_pd(acc + g, sum);
+    }
+}
+
+__attribute__((target("avx512f")))
+inline void avx512SliceDot(const float* values, const size_t* cols, const size_t* lengths, size_t lanes,
+                           const float* x, float* acc) {
+    for (size_t g = 0; g < lanes; g += 8) {
+        __m512i len = _mm512_loadu_si512(lengths + g);
+        __m256 sum = _mm256_setzero_ps();
+        size_t width = sliceGroupWidth(lengths + g, 8);
+        for (size_t k = 0; k < width; ++k) {
+            __mmask8 mask = _mm512_cmpgt_epu64_mask(len, _mm512_set1_epi64(static_cast<long long>(k)));
+            __m512i idx = _mm512_loadu_si512(cols + k * lanes + g);
+            __m256 xs = _mm512_mask_i64gather_ps(_mm256_setzero_ps(), mask, idx, x, 4);
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(values + k * lanes + g), xs));
+        }
+        _mm256_storeu_ps(acc + g, sum);
+    }
+}
+
+inline SimdLevel detectSimdLevel() {
+    static const SimdLevel level = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+        return SimdLevel::Scalar;
+    }();
+    return level;
+}
+
+#else
+
+inline SimdLevel detectSimdLevel() {
+    return SimdLevel::Scalar;
+}
+
+#endif
+
+// Чи можна подавати індекси типу Index у векторні ядра для матриці з cols стовпцями
+template<typename Index>
+inline bool simdGatherFits(size_t cols) {
+    if (std::is_same<Index, size_t>::value) return true;
+    return std::is_same<Index, uint32_t>::value && cols <= (size_t(1) << 31);
+}
+
+template<typename T, typename Index>
+inline T simdRowDot(const T* values, const Index* cols, size_t begin, size_t end, const T* x) {
+#ifdef SPARSE_SIMD_X86
+    if constexpr (std::is_same<Index, size_t>::value || std::is_same<Index, uint32_t>::value) {
+        switch (detectSimdLevel()) {
+            case SimdLevel::AVX512: return avx512RowDot(values, cols, begin, end, x);
+            case SimdLevel::AVX2: return avx2RowDot(values, cols, begin, end, x);
+            default: break;
+        }
+    }
+#endif
+    return scalarRowDot(values, cols, begin, end, x);
+}
+
+template<typename T>
+inline void simdSliceDot(const T* values, const size_t* cols, const size_t* lengths, size_t lanes,
+                         const T* x, T* acc) {
+#ifdef SPARSE_SIMD_X86
+    if constexpr (std::is_same<T, double>::value || std::is_same<T, float>::value) {
+        SimdLevel level = detectSimdLevel();
+        if (level == SimdLevel::AVX512 && lanes % 8 == 0) {
+            avx512SliceDot(values, cols, lengths, lanes, x, acc);
+            return;
+        }
+        if (level != SimdLevel::Scalar && lanes % 4 == 0) {
+            avx2SliceDot(values, cols, lengths, lanes, x, acc);
+            return;
+        }
+    }
+#endif
+    scalarSliceDot(values, cols, lengths, lanes, x, acc);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,245 @@
+#ifndef SPARSEBINARYFORMAT_H
+#define SPARSEBINARYFORMAT_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <limits>
+
+// Двійковий формат розріджених структур:
+//   заголовок 64 байти | значення за замовчуванням | масиви, кожен вирівняний на 64 байти
+// CSR-матриця: rowPointers (rows + 1), colIndices (nnz), values (nnz), індекси як uint64.
+// Список: indices (nnz), values (nnz). Контрольна сума FNV-1a рахується по заголовку
+// (з нульовим полем checksum) і по всьому, що йде після нього
+enum class SparseBinaryKind : uint32_t {
+    CSRMatrix = 1,
+    List = 2
+};
+
+struct SparseBinaryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t kind;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t nonZeros;
+    uint32_t valueSize;
+    uint32_t indexSize;
+    uint64_t checksum;
+    uint64_t reserved;
+};
+
+static_assert(sizeof(SparseBinaryHeader) == 64, "Binary header must be 64 bytes");
+
+const char SPARSE_BINARY_MAGIC[8] = { 'S', 'P', 'A', 'R', 'S', 'E', 'B', '\0' };
+const uint32_t SPARSE_BINARY_VERSION = 2;
+const size_t SPARSE_BINARY_ALIGNMENT = 64;
+
+inline uint64_t sparseBinaryChecksum(const void* data, size_t bytes, uint64_t hash = 1469598103934665603ULL) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < bytes; ++i) {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+inline size_t sparseBinaryAlign(size_t offset) {
+    return (offset + SPARSE_BINARY_ALIGNMENT - 1) / SPARSE_BINARY_ALIGNMENT * SPARSE_BINARY_ALIGNMENT;
+}
+
+// Кінець масиву з count елементів розміру elementSize, що починається з першої
+// вирівняної позиції після offset; переповнення означає пошкоджений заголовок
+inline size_t sparseBinaryArrayEnd(size_t offset, uint64_t count, size_t elementSize) {
+    if (offset > SIZE_MAX - SPARSE_BINARY_ALIGNMENT) throw std::runtime_error("Invalid file format");
+    size_t start = sparseBinaryAlign(offset);
+    if (count > (SIZE_MAX - start) / elementSize) throw std::runtime_error("Invalid file format");
+    return start + static_cast<size_t>(count) * elementSize;
+}
+
+// Початок хешу: заголовок із нульовим полем checksum
+inline uint64_t sparseBinaryHeaderChecksum(const SparseBinaryHeader& header) {
+    SparseBinaryHeader copy = header;
+    copy.checksum = 0;
+    return sparseBinaryChecksum(&copy, sizeof(copy));
+}
+
+// Кінець останнього масиву за розмірами із заголовка. Порівнюється з довжиною файлу
+// до будь-яких виділень пам'яті, тож пошкоджені nonZeros чи rows не призводять до bad_alloc
+inline size_t sparseBinaryPayloadEnd(const SparseBinaryHeader& header) {
+    size_t offset = sparseBinaryArrayEnd(sizeof(SparseBinaryHeader), 1, header.valueSize);
+    if (header.kind == static_cast<uint32_t>(SparseBinaryKind::CSRMatrix)) {
+        if (header.rows == UINT64_MAX) throw std::runtime_error("Invalid file format");
+        offset = sparseBinaryArrayEnd(offset, header.rows + 1, sizeof(uint64_t));
+    }
+    offset = sparseBinaryArrayEnd(offset, header.nonZeros, sizeof(uint64_t));
+    return sparseBinaryArrayEnd(offset, header.nonZeros, header.valueSize);
+}
+
+// Структурна перевірка прочитаних масивів CSR за O(rows + nnz): вказівники рядків
+// неспадні від 0 до nnz, стовпці менші за cols і строго зростають у межах рядка
+template<typename Index>
+bool sparseBinaryValidCSR(const Index* rowPointers, const Index* colIndices,
+                          uint64_t rows, uint64_t cols, uint64_t nonZeros) {
+    if (rowPointers[0] != 0 || rowPointers[rows] != nonZeros) return false;
+    for (uint64_t i = 0; i < rows; ++i) {
+        uint64_t begin = rowPointers[i], end = rowPointers[i + 1];
+        if (end < begin || end > nonZeros) return false;
+        for (uint64_t j = begin; j < end; ++j) {
+            if (colIndices[j] >= cols || (j > begin && colIndices[j] <= colIndices[j - 1])) return false;
+        }
+    }
+    return true;
+}
+
+// Індекси списку строго зростають і менші за його розмір
+template<typename Index>
+bool sparseBinaryValidList(const Index* indices, uint64_t size, uint64_t nonZeros) {
+    for (uint64_t i = 0; i < nonZeros; ++i) {
+        if (indices[i] >= size || (i > 0 && indices[i] <= indices[i - 1])) return false;
+    }
+    return true;
+}
+
+class SparseBinaryWriter {
+private:
+    std::ofstream out;
+    SparseBinaryHeader header;
+    uint64_t hash = 1469598103934665603ULL;
+    size_t offset = 0;
+    
+    void writeRaw(const void* data, size_t bytes) {
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        hash = sparseBinaryChecksum(data, bytes, hash);
+        offset += bytes;
+    }
+    
+public:
+    SparseBinaryWriter(const std::string& filename, SparseBinaryKind kind,
+                       uint64_t rows, uint64_t cols, uint64_t nonZeros, uint32_t valueSize)
+        : out(filename, std::ios::binary) {
+        if (!out) throw std::runtime_error("Cannot open file for writing");
+        
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, SPARSE_BINARY_MAGIC, sizeof(header.magic));
+        header.version = SPARSE_BINARY_VERSION;
+        header.kind = static_cast<uint32_t>(kind);
+        header.rows = rows;
+        header.cols = cols;
+        header.nonZeros = nonZeros;
+        header.valueSize = valueSize;
+        header.indexSize = sizeof(uint64_t);
+        hash = sparseBinaryHeaderChecksum(header);
+        
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        offset = sizeof(header);
+    }
+    
+    void writeArray(const void* data, size_t bytes) {
+        static const char zeros[SPARSE_BINARY_ALIGNMENT] = {};
+        writeRaw(zeros, sparseBinaryAlign(offset) - offset);
+        writeRaw(data, bytes);
+    }
+    
+    template<typename Index>
+    void writeIndices(const Index* data, size_t count) {
+        if (sizeof(Index) == sizeof(uint64_t)) {
+            writeArray(data, count * sizeof(uint64_t));
+            return;
+        }
+        static const char zeros[SPARSE_BINARY_ALIGNMENT] = {};
+        writeRaw(zeros, sparseBinaryAlign(offset) - offset);
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t value = data[i];
+            writeRaw(&value, sizeof(value));
+        }
+    }
+    
+    void finish() {
+        header.checksum = hash;
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.flush();
+        if (!out) throw std::runtime_error("Error while writing binary file");
+    }
+};
+
+class SparseBinaryReader {
+private:
+    std::ifstream in;
+    SparseBinaryHeader header;
+    uint64_t hash = 1469598103934665603ULL;
+    size_t offset = 0;
+    size_t fileSize = 0;
+    
+    void readRaw(void* data, size_t bytes) {
+        in.read(static_cast<char*>(data), static_cast<std::streamsize>(bytes));
+        if (!in) throw std::runtime_error("Unexpected end of binary file");
+        hash = sparseBinaryChecksum(data, bytes, hash);
+        offset += bytes;
+    }
+    
+    void skipPadding() {
+        char padding[SPARSE_BINARY_ALIGNMENT];
+        readRaw(padding, sparseBinaryAlign(offset) - offset);
+    }
+    
+public:
+    SparseBinaryReader(const std::string& filename, SparseBinaryKind kind, uint32_t valueSize)
+        : in(filename, std::ios::binary) {
+        if (!in) throw std::runtime_error("Cannot open file for reading");
+        
+        in.seekg(0, std::ios::end);
+        fileSize = static_cast<size_t>(in.tellg());
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || std::memcmp(header.magic, SPARSE_BINARY_MAGIC, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("Invalid file format");
+        }
+        if (header.version != SPARSE_BINARY_VERSION) {
+            throw std::runtime_error("Unsupported binary format version");
+        }
+        if (header.kind != static_cast<uint32_t>(kind) || header.valueSize != valueSize
+            || header.indexSize != sizeof(uint64_t)) {
+            throw std::runtime_error("Binary file does not match the container type");
+        }
+        if (sparseBinaryPayloadEnd(header) > fileSize) throw std::runtime_error("Invalid file format");
+        hash = sparseBinaryHeaderChecksum(header);
+        offset = sizeof(header);
+    }
+    
+    const SparseBinaryHeader& getHeader() const { return header; }
+    
+    void readArray(void* data, size_t bytes) {
+        skipPadding();
+        readRaw(data, bytes);
+    }
+    
+    template<typename Index>
+    void readIndices(Index* data, size_t count) {
+        if (sizeof(Index) == sizeof(uint64_t)) {
+            readArray(data, count * sizeof(uint64_t));
+            return;
+        }
+        skipPadding();
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t value;
+            readRaw(&value, sizeof(value));
+            if (value > static_cast<uint64_t>(std::numeric_limits<Index>::max())) {
+                throw std::runtime_error("Invalid file format");
+            }
+            data[i] = static_cast<Index>(value);
+        }
+    }
+    
+    void verify() {
+        if (hash != header.checksum) {
+            throw std::runtime_error("Binary file checksum mismatch");
+        }
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,205 @@
+#ifndef SPARSEGENERATORS_H
+#define SPARSEGENERATORS_H
+
+#include "SparseRandom.h"
+#include "SparseMatrix.h"
+#include "SparseList.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+// Розподіл ненульових елементів по рядках
+enum class RowDistribution {
+    Uniform,    // кожен рядок отримує однакову кількість елементів (з точністю до одного)
+    Banded,     // рядок i заповнює лише стовпці [i - bandwidth, i + bandwidth]
+    PowerLaw    // частка рядка з рангом r пропорційна (r + 1)^-exponent, ранги перемішані
+};
+
+struct SparseGeneratorOptions {
+    uint64_t seed = 1;
+    RowDistribution distribution = RowDistribution::Uniform;
+    size_t bandwidth = 1;
+    double powerLawExponent = 1.0;
+    size_t rowsPerTask = 1024;
+};
+
+// Генератор випадкових розріджених структур з точною кількістю ненульових елементів.
+// Позиції в рядку вибираються без повторень, CSR будується одразу паралельно.
+// Кожна група з rowsPerTask рядків має власний потік xoshiro256 із (seed, номер групи),
+// тому результат відтворюється при тому ж зерні незалежно від кількості потоків пулу.
+// valueGenerator викликається з кількох потоків одночасно і має бути потокобезпечним
+template<typename T>
+class SparseGenerator {
+public:
+    using ValueGenerator = std::function<T(Xoshiro256&)>;
+    
+private:
+    SparseGeneratorOptions options;
+    ValueGenerator valueGenerator;
+    T defaultValue;
+    
+    static T uniformValue(Xoshiro256& rng) {
+        if constexpr (std::is_floating_point<T>::value) {
+            return static_cast<T>(1.0 + 9.0 * rng.nextDouble());
+        } else {
+            return static_cast<T>(1 + rng.nextBelow(9));
+        }
+    }
+    
+    // Вікно стовпців рядка [first, last)
+    void columnWindow(size_t row, size_t cols, size_t& first, size_t& last) const {
+        if (options.distribution != RowDistribution::Banded) {
+            first = 0;
+            last = cols;
+            return;
+        }
+        first = row > options.bandwidth ? row - options.bandwidth : 0;
+        last = std::min(cols, row + options.bandwidth + 1);
+        if (first > last) first = last;
+    }
+    
+    // Розподіл total між рядками пропорційно вагам з обмеженням місткості рядка.
+    // Залишок після округлення вниз роздається по одному в порядку спадання ваги
+    static std::vector<size_t> apportion(size_t total, const std::vector<double>& weights,
+                                         const std::vector<size_t>& capacity, Xoshiro256& rng) {
+        size_t n = weights.size();
+        size_t available = 0;
+        double weightSum = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            available += capacity[i];
+            if (capacity[i] > 0) weightSum += weights[i];
+        }
+        if (total > available) {
+            throw std::invalid_argument("Requested nonzeros exceed the available positions");
+        }
+        
+        std::vector<size_t> counts(n, 0);
+        size_t assigned = 0;
+        for (size_t i = 0; i < n && weightSum > 0.0; ++i) {
+            if (capacity[i] == 0) continue;
+            size_t share = static_cast<size_t>(std::floor(static_cast<double>(total) * weights[i] / weightSum));
+            counts[i] = std::min(capacity[i], share);
+            assigned += counts[i];
+        }
+        
+        std::vector<size_t> order(n);
+        for (size_t i = 0; i < n; ++i) order[i] = i;
+        for (size_t i = n; i > 1; --i) {
+            std::swap(order[i - 1], order[rng.nextBelow(i)]);
+        }
+        std::stable_sort(order.begin(), order.end(),
+            [&](size_t a, size_t b) { return weights[a] > weights[b]; });
+        
+        // Похибка округлення може дати на кілька елементів більше: їх забирають найлегші рядки
+        for (auto it = order.rbegin(); assigned > total && it != order.rend(); ++it) {
+            if (counts[*it] > 0) {
+                --counts[*it];
+                --assigned;
+            }
+        }
+        while (assigned < total) {
+            for (size_t i : order) {
+                if (counts[i] < capacity[i]) {
+                    ++counts[i];
+                    if (++assigned == total) break;
+                }
+            }
+        }
+        return counts;
+    }
+    
+    std::vector<size_t> rowCounts(size_t rows, size_t cols, size_t nonZeros) const {
+        Xoshiro256 rng(options.seed, ~uint64_t(0));
+        std::vector<double> weights(rows, 1.0);
+        std::vector<size_t> capacity(rows, cols);
+        
+        if (options.distribution == RowDistribution::Banded) {
+            for (size_t i = 0; i < rows; ++i) {
+                size_t first, last;
+                columnWindow(i, cols, first, last);
+                capacity[i] = last - first;
+                weights[i] = static_cast<double>(capacity[i]);
+            }
+        } else if (options.distribution == RowDistribution::PowerLaw) {
+            std::vector<size_t> rank(rows);
+            for (size_t i = 0; i < rows; ++i) rank[i] = i;
+            for (size_t i = rows; i > 1; --i) {
+                std::swap(rank[i - 1], rank[rng.nextBelow(i)]);
+            }
+            for (size_t i = 0; i < rows; ++i) {
+                weights[i] = std::pow(static_cast<double>(rank[i] + 1), -options.powerLawExponent);
+            }
+        }
+        
+        return apportion(nonZeros, weights, capacity, rng);
+    }
+    
+public:
+    explicit SparseGenerator(const SparseGeneratorOptions& opts = SparseGeneratorOptions(),
+                             ValueGenerator generator = ValueGenerator(), const T& defVal = T())
+        : options(opts), valueGenerator(generator ? generator : ValueGenerator(uniformValue)),
+          defaultValue(defVal) {
+        if (options.rowsPerTask == 0) options.rowsPerTask = 1;
+    }
+    
+    const SparseGeneratorOptions& getOptions() const { return options; }
+    
+    CSRSparseMatrix<T> generateMatrix(size_t rows, size_t cols, size_t nonZeros,
+                                      ThreadPool& pool = ThreadPool::shared()) const {
+        std::vector<size_t> counts = rowCounts(rows, cols, nonZeros);
+        std::vector<size_t> rowPointers(rows + 1, 0);
+        for (size_t i = 0; i < rows; ++i) {
+            rowPointers[i + 1] = rowPointers[i] + counts[i];
+        }
+        std::vector<size_t>().swap(counts);
+        
+        std::vector<size_t> colIndices(nonZeros);
+        std::vector<T> values(nonZeros);
+        size_t tasks = (rows + options.rowsPerTask - 1) / options.rowsPerTask;
+        
+        pool.parallelFor(tasks, [&](size_t task) {
+            Xoshiro256 rng(options.seed, task);
+            std::vector<uint64_t> sample;
+            size_t begin = task * options.rowsPerTask;
+            size_t end = std::min(rows, begin + options.rowsPerTask);
+            
+            for (size_t i = begin; i < end; ++i) {
+                size_t first, last;
+                columnWindow(i, cols, first, last);
+                sampleWithoutReplacement(last - first, rowPointers[i + 1] - rowPointers[i], rng, sample);
+                
+                size_t pos = rowPointers[i];
+                for (uint64_t offset : sample) {
+                    colIndices[pos] = first + static_cast<size_t>(offset);
+                    values[pos] = drawNonDefault([&]() { return valueGenerator(rng); }, defaultValue);
+                    ++pos;
+                }
+            }
+        });
+        
+        return CSRSparseMatrix<T>::fromArrays(rows, cols, std::move(rowPointers), std::move(colIndices),
+                                              std::move(values), defaultValue);
+    }
+    
+    SparseList<T> generateList(size_t size, size_t nonZeros) const {
+        if (nonZeros > size) {
+            throw std::invalid_argument("Requested nonzeros exceed the available positions");
+        }
+        
+        Xoshiro256 rng(options.seed);
+        std::vector<uint64_t> positions;
+        sampleWithoutReplacement(size, nonZeros, rng, positions);
+        
+        SparseList<T> result(size, defaultValue);
+        for (uint64_t index : positions) {
+            result.set(static_cast<size_t>(index), drawNonDefault([&]() { return valueGenerator(rng); }, defaultValue));
+        }
+        return result;
+    }
+};
+
+#endif
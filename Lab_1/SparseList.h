@@ -2,17 +2,114 @@
 #define SPARSELIST_H
 
 #include "ISparseContainer.h"
+#include "SparseBinaryFormat.h"
+#include "SparseRandom.h"
+#include "ThreadPool.h"
 #include <map>
+#include <memory>
+#include <utility>
 #include <sstream>
 #include <fstream>
 #include <stdexcept>
+#include <vector>
+#include <type_traits>
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+#include <cstdlib>
 
 template<typename T>
 class SparseList : public ISparseContainer<T> {
 private:
+    // Збережені елементи, переписані в суцільні масиви для паралельних масових операцій
+    struct StoredEntries {
+        std::vector<size_t> indices;
+        std::vector<T> values;
+    };
+    
     std::map<size_t, T> data;
     size_t listSize;
     T defaultValue;
+    mutable std::shared_ptr<const StoredEntries> entriesCache;
+    
+    template<typename> friend class SparseList;
+    
+    // Знімок будується при першій масовій операції й скидається при будь-якій зміні,
+    // тож обхід дерева за вказівниками робиться один раз, а не в кожній операції.
+    // Константні методи можна викликати з кількох потоків одночасно: вказівник на знімок
+    // читається і встановлюється атомарно, і якщо два потоки збудували знімок разом,
+    // зберігається перший, а другий просто відкидається
+    const StoredEntries& storedEntries() const {
+        std::shared_ptr<const StoredEntries> current = std::atomic_load(&entriesCache);
+        if (!current) {
+            std::shared_ptr<StoredEntries> entries = std::make_shared<StoredEntries>();
+            entries->indices.reserve(data.size());
+            entries->values.reserve(data.size());
+            for (const auto& pair : data) {
+                entries->indices.push_back(pair.first);
+                entries->values.push_back(pair.second);
+            }
+            std::shared_ptr<const StoredEntries> built = entries;
+            if (std::atomic_compare_exchange_strong(&entriesCache, &current, built)) current = built;
+        }
+        return *current;
+    }
+    
+    // Кількість блоків для count елементів: дрібні блоки не варті накладних витрат пулу
+    static size_t chunkCount(size_t count, const ThreadPool& pool) {
+        const size_t minChunk = 4096;
+        return std::max<size_t>(1, std::min(pool.size() * 4, count / minChunk));
+    }
+    
+    // Ділить [0, count) на chunks суцільних блоків і виконує body(блок, begin, end) на пулі
+    template<typename Body>
+    static void parallelChunks(size_t count, size_t chunks, ThreadPool& pool, Body body) {
+        pool.parallelFor(chunks, [&](size_t c) {
+            body(c, count * c / chunks, count * (c + 1) / chunks);
+        });
+    }
+    
+    // value op value op ... (count разів) подвоєнням, O(log count) викликів op
+    template<typename BinaryOp>
+    static T repeat(T value, size_t count, BinaryOp op) {
+        T result = value;
+        bool first = true;
+        for (; count > 0; count >>= 1) {
+            if (count & 1) {
+                result = first ? value : op(result, value);
+                first = false;
+            }
+            if (count > 1) value = op(value, value);
+        }
+        return result;
+    }
+    
+    void requireSameSize(const SparseList<T>& other) const {
+        if (listSize != other.listSize) {
+            throw std::invalid_argument("List sizes must match");
+        }
+    }
+    
+    // Обходить об'єднання збережених індексів обох списків у порядку зростання
+    template<typename Visitor>
+    void mergeWith(const SparseList<T>& other, Visitor visit) const {
+        auto a = data.begin();
+        auto b = other.data.begin();
+        while (a != data.end() || b != other.data.end()) {
+            if (b == other.data.end() || (a != data.end() && a->first < b->first)) {
+                visit(a->first, a->second, other.defaultValue);
+                ++a;
+            } else if (a == data.end() || b->first < a->first) {
+                visit(b->first, defaultValue, b->second);
+                ++b;
+            } else {
+                visit(a->first, a->second, b->second);
+                ++a;
+                ++b;
+            }
+        }
+    }
     
 public:
     SparseList(size_t size = 0, const T& defVal = T()) 
@@ -30,6 +127,7 @@ public:
         if (index >= listSize) {
             listSize = index + 1;
         }
+        entriesCache.reset();
         
         if (value == defaultValue) {
             data.erase(index);
@@ -38,14 +136,43 @@ public:
         }
     }
     
+    class const_iterator {
+    private:
+        typename std::map<size_t, T>::const_iterator it;
+        
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = SparseEntry<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = SparseEntry<T>;
+        
+        explicit const_iterator(typename std::map<size_t, T>::const_iterator i) : it(i) {}
+        
+        SparseEntry<T> operator*() const { return SparseEntry<T>{it->first, it->second}; }
+        const_iterator& operator++() { ++it; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++it; return old; }
+        bool operator==(const const_iterator& other) const { return it == other.it; }
+        bool operator!=(const const_iterator& other) const { return it != other.it; }
+    };
+    
+    const_iterator begin() const { return const_iterator(data.begin()); }
+    const_iterator end() const { return const_iterator(data.end()); }
+    
+    void forEachNonZero(const std::function<void(size_t, const T&)>& visit) const override {
+        for (const auto& pair : data) {
+            visit(pair.first, pair.second);
+        }
+    }
+    
     int findByValue(const T& value) const override {
         if (value == defaultValue) {
-            for (size_t i = 0; i < listSize; ++i) {
-                if (data.find(i) == data.end()) {
-                    return static_cast<int>(i);
-                }
+            size_t expected = 0;
+            for (const auto& pair : data) {
+                if (pair.first != expected) break;
+                ++expected;
             }
-            return -1;
+            return expected < listSize ? static_cast<int>(expected) : -1;
         }
         
         for (const auto& pair : data) {
@@ -56,14 +183,21 @@ public:
         return -1;
     }
     
+    // Обхід лише збережених елементів: пропуск між ними означає неявний defaultValue,
+    // тож предикат для значення за замовчуванням перевіряється один раз
     int findFirstBy(std::function<bool(const T&)> predicate) const override {
-        for (size_t i = 0; i < listSize; ++i) {
-            T val = get(i);
-            if (predicate(val)) {
-                return static_cast<int>(i);
+        bool defaultMatches = predicate(defaultValue);
+        size_t expected = 0;
+        for (const auto& pair : data) {
+            if (defaultMatches && pair.first != expected) {
+                return static_cast<int>(expected);
+            }
+            if (predicate(pair.second)) {
+                return static_cast<int>(pair.first);
             }
+            expected = pair.first + 1;
         }
-        return -1;
+        return (defaultMatches && expected < listSize) ? static_cast<int>(expected) : -1;
     }
     
     size_t size() const override {
@@ -77,9 +211,14 @@ public:
     std::string toString() const override {
         std::ostringstream oss;
         oss << "SparseList[size=" << listSize << ", stored=" << data.size() << "]: [";
+        auto it = data.begin();
         for (size_t i = 0; i < std::min(listSize, size_t(10)); ++i) {
             if (i > 0) oss << ", ";
-            oss << get(i);
+            if (it != data.end() && it->first == i) {
+                oss << (it++)->second;
+            } else {
+                oss << defaultValue;
+            }
         }
         if (listSize > 10) oss << ", ...";
         oss << "]";
@@ -89,6 +228,7 @@ public:
     void clear() override {
         data.clear();
         listSize = 0;
+        entriesCache.reset();
     }
     
     void saveToFile(const std::string& filename) const override {
@@ -124,13 +264,303 @@ public:
         }
     }
     
-    void generateRandom(size_t size, double density, std::function<T()> generator) {
+    void saveBinary(const std::string& filename) const {
+        static_assert(std::is_trivially_copyable<T>::value, "Binary format requires trivially copyable values");
+        
+        std::vector<size_t> indices;
+        std::vector<T> values;
+        indices.reserve(data.size());
+        values.reserve(data.size());
+        for (const auto& pair : data) {
+            indices.push_back(pair.first);
+            values.push_back(pair.second);
+        }
+        
+        SparseBinaryWriter writer(filename, SparseBinaryKind::List, listSize, 1, data.size(), sizeof(T));
+        writer.writeArray(&defaultValue, sizeof(T));
+        writer.writeIndices(indices.data(), indices.size());
+        writer.writeArray(values.data(), values.size() * sizeof(T));
+        writer.finish();
+    }
+    
+    void loadBinary(const std::string& filename) {
+        static_assert(std::is_trivially_copyable<T>::value, "Binary format requires trivially copyable values");
+        
+        SparseBinaryReader reader(filename, SparseBinaryKind::List, sizeof(T));
+        const SparseBinaryHeader& header = reader.getHeader();
+        
+        T defVal;
+        std::vector<size_t> indices(header.nonZeros);
+        std::vector<T> values(header.nonZeros);
+        reader.readArray(&defVal, sizeof(T));
+        reader.readIndices(indices.data(), indices.size());
+        reader.readArray(values.data(), values.size() * sizeof(T));
+        reader.verify();
+        
+        if (!sparseBinaryValidList(indices.data(), header.rows, header.nonZeros)) {
+            throw std::runtime_error("Invalid file format");
+        }
+        clear();
+        listSize = header.rows;
+        defaultValue = defVal;
+        for (size_t i = 0; i < indices.size(); ++i) {
+            data.emplace_hint(data.end(), indices[i], values[i]);
+        }
+    }
+    
+    // Векторні операції зливають впорядковані map за O(nnz1 + nnz2);
+    // відсутні елементи дорівнюють defaultValue відповідного списку
+    T dot(const SparseList<T>& other) const {
+        requireSameSize(other);
+        T sum = T();
+        size_t visited = 0;
+        mergeWith(other, [&](size_t, const T& a, const T& b) {
+            sum = sum + a * b;
+            ++visited;
+        });
+        if (visited < listSize) {
+            sum = sum + static_cast<T>(listSize - visited) * (defaultValue * other.defaultValue);
+        }
+        return sum;
+    }
+    
+    T dot(const std::vector<T>& dense) const {
+        if (dense.size() != listSize) {
+            throw std::invalid_argument("List sizes must match");
+        }
+        T sum = T();
+        if (defaultValue == T()) {
+            for (const auto& pair : data) {
+                sum = sum + pair.second * dense[pair.first];
+            }
+            return sum;
+        }
+        for (size_t i = 0; i < listSize; ++i) {
+            auto it = data.find(i);
+            sum = sum + (it != data.end() ? it->second : defaultValue) * dense[i];
+        }
+        return sum;
+    }
+    
+    // this = this + alpha * x
+    void axpy(const T& alpha, const SparseList<T>& x) {
+        requireSameSize(x);
+        T newDefault = defaultValue + alpha * x.defaultValue;
+        std::map<size_t, T> result;
+        mergeWith(x, [&](size_t index, const T& a, const T& b) {
+            T value = a + alpha * b;
+            if (value != newDefault) result.emplace_hint(result.end(), index, value);
+        });
+        data.swap(result);
+        defaultValue = newDefault;
+        entriesCache.reset();
+    }
+    
+    // y = y + alpha * this
+    void axpyTo(const T& alpha, std::vector<T>& y) const {
+        if (y.size() != listSize) {
+            throw std::invalid_argument("List sizes must match");
+        }
+        if (defaultValue == T()) {
+            for (const auto& pair : data) {
+                y[pair.first] = y[pair.first] + alpha * pair.second;
+            }
+            return;
+        }
+        for (size_t i = 0; i < listSize; ++i) {
+            auto it = data.find(i);
+            y[i] = y[i] + alpha * (it != data.end() ? it->second : defaultValue);
+        }
+    }
+    
+    SparseList<T> add(const SparseList<T>& other) const {
+        requireSameSize(other);
+        SparseList<T> result(listSize, defaultValue + other.defaultValue);
+        mergeWith(other, [&](size_t index, const T& a, const T& b) {
+            T value = a + b;
+            if (value != result.defaultValue) result.data.emplace_hint(result.data.end(), index, value);
+        });
+        return result;
+    }
+    
+    SparseList<T> multiplyElementwise(const SparseList<T>& other) const {
+        requireSameSize(other);
+        SparseList<T> result(listSize, defaultValue * other.defaultValue);
+        mergeWith(other, [&](size_t index, const T& a, const T& b) {
+            T value = a * b;
+            if (value != result.defaultValue) result.data.emplace_hint(result.data.end(), index, value);
+        });
+        return result;
+    }
+    
+    double norm1() const {
+        double sum = static_cast<double>(listSize - data.size()) * std::abs(static_cast<double>(defaultValue));
+        for (const auto& pair : data) {
+            sum += std::abs(static_cast<double>(pair.second));
+        }
+        return sum;
+    }
+    
+    double norm2() const {
+        double d = static_cast<double>(defaultValue);
+        double sum = static_cast<double>(listSize - data.size()) * d * d;
+        for (const auto& pair : data) {
+            double v = static_cast<double>(pair.second);
+            sum += v * v;
+        }
+        return std::sqrt(sum);
+    }
+    
+    double normInf() const {
+        double result = data.size() < listSize ? std::abs(static_cast<double>(defaultValue)) : 0.0;
+        for (const auto& pair : data) {
+            result = std::max(result, std::abs(static_cast<double>(pair.second)));
+        }
+        return result;
+    }
+    
+    // Масові операції над усіма listSize елементами: збережені обробляються паралельно
+    // блоками знімка, а неявні елементи враховуються через значення за замовчуванням без обходу.
+    
+    // Новий список f(x) для кожного x; його значення за замовчуванням — f(defaultValue)
+    template<typename UnaryOp>
+    auto transform(UnaryOp f, ThreadPool& pool = ThreadPool::shared()) const
+        -> SparseList<typename std::decay<decltype(f(std::declval<const T&>()))>::type> {
+        using R = typename std::decay<decltype(f(std::declval<const T&>()))>::type;
+        const StoredEntries& entries = storedEntries();
+        std::vector<R> mapped(entries.values.size());
+        parallelChunks(mapped.size(), chunkCount(mapped.size(), pool), pool, [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) mapped[i] = f(entries.values[i]);
+        });
+        
+        SparseList<R> result(listSize, f(defaultValue));
+        for (size_t i = 0; i < mapped.size(); ++i) {
+            if (mapped[i] != result.defaultValue) {
+                result.data.emplace_hint(result.data.end(), entries.indices[i], std::move(mapped[i]));
+            }
+        }
+        return result;
+    }
+    
+    // Згортка init op x0 op x1 ... по всіх елементах; op має бути асоціативною й комутативною,
+    // бо блоки і неявні елементи комбінуються не в порядку індексів
+    template<typename BinaryOp>
+    T reduce(const T& init, BinaryOp op, ThreadPool& pool = ThreadPool::shared()) const {
+        const StoredEntries& entries = storedEntries();
+        size_t chunks = chunkCount(entries.values.size(), pool);
+        std::vector<T> partial(chunks);
+        parallelChunks(entries.values.size(), chunks, pool, [&](size_t c, size_t begin, size_t end) {
+            if (begin == end) return;
+            T sum = entries.values[begin];
+            for (size_t i = begin + 1; i < end; ++i) sum = op(sum, entries.values[i]);
+            partial[c] = sum;
+        });
+        
+        T result = init;
+        if (!entries.values.empty()) {
+            for (size_t c = 0; c < chunks; ++c) result = op(result, partial[c]);
+        }
+        if (listSize > entries.values.size()) {
+            result = op(result, repeat(defaultValue, listSize - entries.values.size(), op));
+        }
+        return result;
+    }
+    
+    template<typename Predicate>
+    size_t countIf(Predicate predicate, ThreadPool& pool = ThreadPool::shared()) const {
+        const StoredEntries& entries = storedEntries();
+        std::vector<size_t> partial(chunkCount(entries.values.size(), pool), 0);
+        parallelChunks(entries.values.size(), partial.size(), pool, [&](size_t c, size_t begin, size_t end) {
+            size_t count = 0;
+            for (size_t i = begin; i < end; ++i) {
+                if (predicate(entries.values[i])) ++count;
+            }
+            partial[c] = count;
+        });
+        
+        size_t count = predicate(defaultValue) ? listSize - entries.values.size() : 0;
+        for (size_t part : partial) count += part;
+        return count;
+    }
+    
+    // Той самий розмір і значення за замовчуванням; збережені елементи, що не задовольняють
+    // predicate, стають неявними. Неявні елементи від predicate не залежать
+    template<typename Predicate>
+    SparseList<T> filter(Predicate predicate, ThreadPool& pool = ThreadPool::shared()) const {
+        const StoredEntries& entries = storedEntries();
+        std::vector<char> keep(entries.values.size());
+        parallelChunks(keep.size(), chunkCount(keep.size(), pool), pool, [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) keep[i] = predicate(entries.values[i]) ? 1 : 0;
+        });
+        
+        SparseList<T> result(listSize, defaultValue);
+        for (size_t i = 0; i < keep.size(); ++i) {
+            if (keep[i]) result.data.emplace_hint(result.data.end(), entries.indices[i], entries.values[i]);
+        }
+        return result;
+    }
+    
+    // k пар (індекс, значення) з найбільшими за comp значеннями, від найбільшого;
+    // рівні значення впорядковуються за індексом. Неявні елементи беруть участь як
+    // defaultValue: якщо воно випереджає збережені, додаються найменші вільні індекси
+    template<typename Compare = std::greater<T>>
+    std::vector<std::pair<size_t, T>> topK(size_t k, Compare comp = Compare(),
+                                           ThreadPool& pool = ThreadPool::shared()) const {
+        using Entry = std::pair<size_t, T>;
+        auto before = [&](const Entry& a, const Entry& b) {
+            if (comp(a.second, b.second)) return true;
+            if (comp(b.second, a.second)) return false;
+            return a.first < b.first;
+        };
+        
+        const StoredEntries& entries = storedEntries();
+        k = std::min(k, listSize);
+        std::vector<std::vector<Entry>> partial(chunkCount(entries.values.size(), pool));
+        parallelChunks(entries.values.size(), partial.size(), pool, [&](size_t c, size_t begin, size_t end) {
+            std::vector<Entry>& best = partial[c];
+            best.reserve(end - begin);
+            for (size_t i = begin; i < end; ++i) best.emplace_back(entries.indices[i], entries.values[i]);
+            if (best.size() > k) {
+                std::nth_element(best.begin(), best.begin() + k, best.end(), before);
+                best.resize(k);
+            }
+        });
+        
+        std::vector<Entry> result;
+        for (const std::vector<Entry>& best : partial) {
+            result.insert(result.end(), best.begin(), best.end());
+        }
+        
+        // Неявних кандидатів вистачає не більше k, і всі вони рівні між собою
+        size_t implicitCount = std::min(k, listSize - entries.values.size());
+        size_t candidate = 0;
+        for (size_t i = 0; i <= entries.indices.size() && implicitCount > 0; ++i) {
+            size_t next = i < entries.indices.size() ? entries.indices[i] : listSize;
+            for (; candidate < next && implicitCount > 0; ++candidate, --implicitCount) {
+                result.emplace_back(candidate, defaultValue);
+            }
+            candidate = next + 1;
+        }
+        
+        size_t count = std::min(k, result.size());
+        std::partial_sort(result.begin(), result.begin() + count, result.end(), before);
+        result.resize(count);
+        return result;
+    }
+    
+    // Рівно size * density різних позицій; без явного зерна воно береться з rand(),
+    // тож послідовність, як і раніше, керується srand
+    void generateRandom(size_t size, double density, std::function<T()> generator,
+                        uint64_t seed = static_cast<uint64_t>(std::rand())) {
         clear();
         listSize = size;
-        size_t count = static_cast<size_t>(size * density);
-        for (size_t i = 0; i < count; ++i) {
-            size_t idx = rand() % size;
-            data[idx] = generator();
+        size_t count = std::min(size, static_cast<size_t>(size * density));
+        
+        Xoshiro256 rng(seed);
+        std::vector<uint64_t> positions;
+        sampleWithoutReplacement(size, count, rng, positions);
+        for (uint64_t idx : positions) {
+            data.emplace_hint(data.end(), static_cast<size_t>(idx), drawNonDefault(generator, defaultValue));
         }
     }
 };
@@ -1,12 +1,23 @@
 #ifndef SPARSEMATRIX_H
 #define SPARSEMATRIX_H
 
+#include "ThreadPool.h"
+#include "SimdKernels.h"
+#include "SparseBinaryFormat.h"
+#include "SparseRandom.h"
 #include <map>
 #include <vector>
 #include <sstream>
 #include <fstream>
 #include <stdexcept>
 #include <cmath>
+#include <algorithm>
+#include <limits>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <memory>
+#include <cstdlib>
 
 template<typename T>
 class SparseMatrix {
@@ -28,16 +39,40 @@ public:
     
     size_t getRows() const { return rows; }
     size_t getCols() const { return cols; }
+    const T& getDefaultValue() const { return defaultValue; }
     
     virtual SparseMatrix<T>* add(const SparseMatrix<T>& other) const = 0;
     virtual SparseMatrix<T>* multiply(const SparseMatrix<T>& other) const = 0;
     virtual std::vector<T> multiplyVector(const std::vector<T>& vec) const = 0;
+    
+    // Варіант без виділення пам'яті: result перевикористовує свою ємність між викликами
+    virtual void multiplyVector(const std::vector<T>& vec, std::vector<T>& result) const {
+        result = multiplyVector(vec);
+    }
     virtual SparseMatrix<T>* transpose() const = 0;
     
+    // Обходить елементи, відмінні від defaultValue, рядок за рядком, у рядку — за зростанням
+    // стовпця. Базова версія перебирає всі позиції через get(); формати перевизначають її
+    // обходом власних масивів, тож перетворення між форматами коштує O(nnz)
+    virtual void forEachNonZero(const std::function<void(size_t, size_t, const T&)>& visit) const {
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                T value = get(i, j);
+                if (value != defaultValue) visit(i, j, value);
+            }
+        }
+    }
+    
     virtual void saveToFile(const std::string& filename) const = 0;
     virtual void loadFromFile(const std::string& filename) = 0;
 };
 
+template<typename T, typename Index = size_t>
+class CSRSparseMatrix;
+
+template<typename T, typename Index = size_t>
+class CSRRowView;
+
 template<typename T>
 class MapSparseMatrix : public SparseMatrix<T> {
 private:
@@ -47,6 +82,39 @@ private:
     using SparseMatrix<T>::cols;
     using SparseMatrix<T>::defaultValue;
     
+    template<typename, typename> friend class CSRSparseMatrix;
+    
+    // Наступна позиція в порядку ключів map: рядок за рядком
+    std::pair<size_t, size_t> following(std::pair<size_t, size_t> pos) const {
+        if (++pos.second == cols) {
+            ++pos.first;
+            pos.second = 0;
+        }
+        return pos;
+    }
+    
+    static const MapSparseMatrix<T>& asMap(const SparseMatrix<T>& other, MapSparseMatrix<T>& storage) {
+        const MapSparseMatrix<T>* map = dynamic_cast<const MapSparseMatrix<T>*>(&other);
+        if (map) return *map;
+        
+        const CSRSparseMatrix<T>* csr = dynamic_cast<const CSRSparseMatrix<T>*>(&other);
+        if (csr) {
+            storage = csr->toMap();
+            return storage;
+        }
+        const CSRSparseMatrix<T, uint32_t>* narrow = dynamic_cast<const CSRSparseMatrix<T, uint32_t>*>(&other);
+        if (narrow) {
+            storage = narrow->toMap();
+            return storage;
+        }
+        
+        storage = MapSparseMatrix<T>(other.getRows(), other.getCols(), other.getDefaultValue());
+        other.forEachNonZero([&](size_t i, size_t j, const T& value) {
+            storage.data.emplace_hint(storage.data.end(), std::make_pair(i, j), value);
+        });
+        return storage;
+    }
+    
 public:
     MapSparseMatrix(size_t r = 0, size_t c = 0, const T& defVal = T())
         : SparseMatrix<T>(r, c, defVal) {}
@@ -101,30 +169,80 @@ public:
     }
     
     SparseMatrix<T>* add(const SparseMatrix<T>& other) const override {
+        return new MapSparseMatrix<T>(added(other));
+    }
+    
+    MapSparseMatrix<T> added(const SparseMatrix<T>& other) const {
         if (rows != other.getRows() || cols != other.getCols()) {
             throw std::invalid_argument("Matrix dimensions must match for addition");
         }
         
-        MapSparseMatrix<T>* result = new MapSparseMatrix<T>(rows, cols, defaultValue);
+        MapSparseMatrix<T> converted;
+        const MapSparseMatrix<T>& rhs = asMap(other, converted);
         
-        for (size_t i = 0; i < rows; ++i) {
-            for (size_t j = 0; j < cols; ++j) {
-                T sum = get(i, j) + other.get(i, j);
-                if (sum != defaultValue) {
-                    result->set(i, j, sum);
-                }
+        MapSparseMatrix<T> result(rows, cols, defaultValue);
+        
+        // Злиття двох впорядкованих map: обходяться лише збережені елементи. Якщо ж сума
+        // значень за замовчуванням відрізняється від defaultValue, нею заповнюються й усі
+        // позиції, не збережені в жодній з матриць
+        const T fill = defaultValue + rhs.defaultValue;
+        const bool dense = fill != defaultValue && cols > 0;
+        std::pair<size_t, size_t> cursor(0, 0);
+        auto fillUntil = [&](const std::pair<size_t, size_t>& pos) {
+            for (; cursor < pos; cursor = following(cursor)) {
+                result.data.emplace_hint(result.data.end(), cursor, fill);
+            }
+        };
+        
+        auto a = data.begin();
+        auto b = rhs.data.begin();
+        while (a != data.end() || b != rhs.data.end()) {
+            std::pair<size_t, size_t> pos;
+            T sum;
+            if (b == rhs.data.end() || (a != data.end() && a->first < b->first)) {
+                pos = a->first;
+                sum = a->second + rhs.defaultValue;
+                ++a;
+            } else if (a == data.end() || b->first < a->first) {
+                pos = b->first;
+                sum = defaultValue + b->second;
+                ++b;
+            } else {
+                pos = a->first;
+                sum = a->second + b->second;
+                ++a;
+                ++b;
+            }
+            if (dense) {
+                fillUntil(pos);
+                cursor = following(pos);
+            }
+            if (sum != defaultValue) {
+                result.data.emplace_hint(result.data.end(), pos, sum);
             }
         }
+        if (dense) fillUntil(std::make_pair(rows, size_t(0)));
         
         return result;
     }
     
     SparseMatrix<T>* multiply(const SparseMatrix<T>& other) const override {
+        return new MapSparseMatrix<T>(multiplied(other));
+    }
+    
+    MapSparseMatrix<T> multiplied(const SparseMatrix<T>& other) const {
         if (cols != other.getRows()) {
             throw std::invalid_argument("Invalid dimensions for matrix multiplication");
         }
         
-        MapSparseMatrix<T>* result = new MapSparseMatrix<T>(rows, other.getCols(), defaultValue);
+        // При нульових значеннях за замовчуванням неявні елементи нічого не додають,
+        // і добуток рахується по рядках ядром CSR за кількістю ненульових добутків
+        if (defaultValue == T() && other.getDefaultValue() == T()) {
+            return toCSR().multiplied(other).toMap();
+        }
+        
+        // Інакше кожна позиція результату залежить від усіх елементів рядка і стовпця
+        MapSparseMatrix<T> result(rows, other.getCols(), defaultValue);
         
         for (size_t i = 0; i < rows; ++i) {
             for (size_t j = 0; j < other.getCols(); ++j) {
@@ -133,7 +251,7 @@ public:
                     sum = sum + get(i, k) * other.get(k, j);
                 }
                 if (sum != defaultValue) {
-                    result->set(i, j, sum);
+                    result.data.emplace_hint(result.data.end(), std::make_pair(i, j), sum);
                 }
             }
         }
@@ -142,29 +260,95 @@ public:
     }
     
     std::vector<T> multiplyVector(const std::vector<T>& vec) const override {
+        std::vector<T> result;
+        multiplyVector(vec, result);
+        return result;
+    }
+    
+    void multiplyVector(const std::vector<T>& vec, std::vector<T>& result) const override {
         if (cols != vec.size()) {
             throw std::invalid_argument("Vector size must match matrix columns");
         }
+        if (&vec == &result) {
+            throw std::invalid_argument("Result vector must not alias the input");
+        }
         
-        std::vector<T> result(rows, defaultValue);
+        result.assign(rows, defaultValue);
+        if (defaultValue == T()) {
+            for (const auto& entry : data) {
+                T& sum = result[entry.first.first];
+                sum = sum + entry.second * vec[entry.first.second];
+            }
+            return;
+        }
+        
+        // Ненульове значення за замовчуванням множиться на кожен елемент vec у тому ж
+        // порядку, що й get(i, j) * vec[j], тож inf і NaN на неявних позиціях не губляться
+        auto it = data.begin();
         for (size_t i = 0; i < rows; ++i) {
             T sum = defaultValue;
             for (size_t j = 0; j < cols; ++j) {
-                sum = sum + get(i, j) * vec[j];
+                if (it != data.end() && it->first.first == i && it->first.second == j) {
+                    sum = sum + it->second * vec[j];
+                    ++it;
+                } else {
+                    sum = sum + defaultValue * vec[j];
+                }
             }
             result[i] = sum;
         }
-        
-        return result;
+    }
+    
+    void forEachNonZero(const std::function<void(size_t, size_t, const T&)>& visit) const override {
+        for (const auto& entry : data) {
+            if (entry.second != defaultValue) visit(entry.first.first, entry.first.second, entry.second);
+        }
     }
     
     SparseMatrix<T>* transpose() const override {
-        MapSparseMatrix<T>* result = new MapSparseMatrix<T>(cols, rows, defaultValue);
-        
+        return new MapSparseMatrix<T>(transposed());
+    }
+    
+    MapSparseMatrix<T> transposed() const {
+        MapSparseMatrix<T> result(cols, rows, defaultValue);
         for (const auto& entry : data) {
-            result->set(entry.first.second, entry.first.first, entry.second);
+            result.data.emplace(std::make_pair(entry.first.second, entry.first.first), entry.second);
+        }
+        return result;
+    }
+    
+    CSRSparseMatrix<T> toCSR() const;
+    
+    // Рядки [begin, end) як окрема матриця: межі діапазону в дереві знаходяться за O(log nnz)
+    MapSparseMatrix<T> rowRange(size_t begin, size_t end) const {
+        if (begin > end || end > rows) {
+            throw std::out_of_range("Row range out of bounds");
         }
         
+        MapSparseMatrix<T> result(end - begin, cols, defaultValue);
+        auto first = data.lower_bound(std::make_pair(begin, size_t(0)));
+        auto last = data.lower_bound(std::make_pair(end, size_t(0)));
+        for (auto it = first; it != last; ++it) {
+            result.data.emplace_hint(result.data.end(),
+                                     std::make_pair(it->first.first - begin, it->first.second), it->second);
+        }
+        return result;
+    }
+    
+    // Прямокутний блок [rowBegin, rowEnd) x [colBegin, colEnd): по одному lower_bound на рядок
+    MapSparseMatrix<T> block(size_t rowBegin, size_t rowEnd, size_t colBegin, size_t colEnd) const {
+        if (rowBegin > rowEnd || rowEnd > rows || colBegin > colEnd || colEnd > cols) {
+            throw std::out_of_range("Block out of bounds");
+        }
+        
+        MapSparseMatrix<T> result(rowEnd - rowBegin, colEnd - colBegin, defaultValue);
+        for (size_t i = rowBegin; i < rowEnd; ++i) {
+            auto it = data.lower_bound(std::make_pair(i, colBegin));
+            for (; it != data.end() && it->first.first == i && it->first.second < colEnd; ++it) {
+                result.data.emplace_hint(result.data.end(),
+                                         std::make_pair(i - rowBegin, it->first.second - colBegin), it->second);
+            }
+        }
         return result;
     }
     
@@ -203,65 +387,458 @@ public:
         }
     }
     
-    void generateRandom(size_t r, size_t c, double density, std::function<T()> generator) {
+    void saveBinary(const std::string& filename) const {
+        toCSR().saveBinary(filename);
+    }
+    
+    void loadBinary(const std::string& filename) {
+        CSRSparseMatrix<T> csr;
+        csr.loadBinary(filename);
+        *this = csr.toMap();
+    }
+    
+    // Рівно r * c * density різних позицій, вибраних без повторень.
+    // Для великих матриць швидше будувати CSR через SparseGenerator
+    void generateRandom(size_t r, size_t c, double density, std::function<T()> generator,
+                        uint64_t seed = static_cast<uint64_t>(std::rand())) {
         rows = r;
         cols = c;
         data.clear();
         
         size_t totalElements = r * c;
-        size_t count = static_cast<size_t>(totalElements * density);
+        size_t count = std::min(totalElements, static_cast<size_t>(totalElements * density));
         
-        for (size_t i = 0; i < count; ++i) {
-            size_t row = rand() % r;
-            size_t col = rand() % c;
-            data[{row, col}] = generator();
+        Xoshiro256 rng(seed);
+        std::vector<uint64_t> positions;
+        sampleWithoutReplacement(totalElements, count, rng, positions);
+        for (uint64_t pos : positions) {
+            data.emplace_hint(data.end(), std::make_pair(static_cast<size_t>(pos / c), static_cast<size_t>(pos % c)),
+                              drawNonDefault(generator, defaultValue));
         }
     }
 };
 
-template<typename T>
+// CSR-матриця з буфером змін: set() не перебудовує масиви, а дописує нові позиції
+// у буфер свого рядка. get і multiplyVector читають буфер напряму, решта операцій
+// спершу зливає його з масивами. Злиття може відбуватися і в const-методах, тому
+// одночасні читання з різних потоків безпечні лише після compact().
+// Index — тип індексів у colIndices і rowPointers: uint32_t удвічі зменшує їхній розмір,
+// якщо розміри і кількість ненульових елементів вміщуються в 32 біти
+template<typename T, typename Index>
 class CSRSparseMatrix : public SparseMatrix<T> {
 private:
-    std::vector<T> values;
-    std::vector<size_t> colIndices;
-    std::vector<size_t> rowPointers;
+    static_assert(std::is_integral<Index>::value && std::is_unsigned<Index>::value,
+                  "CSR index type must be an unsigned integer");
+    
+    mutable std::vector<T> values;
+    mutable std::vector<Index> colIndices;
+    mutable std::vector<Index> rowPointers;
+    mutable std::vector<std::vector<std::pair<size_t, T>>> rowUpdates;
+    mutable size_t pendingUpdates = 0;
+    double compactionRatio = 0.05;
+    mutable std::shared_ptr<const CSRSparseMatrix<T, Index>> columnCache;
     
     using SparseMatrix<T>::rows;
     using SparseMatrix<T>::cols;
     using SparseMatrix<T>::defaultValue;
     
+    template<typename, typename> friend class CSRSparseMatrix;
+    
+    // Перевірка, що значення (розмір чи зміщення) вміщується в тип індексу
+    static Index toIndex(size_t value) {
+        if (value > static_cast<size_t>(std::numeric_limits<Index>::max())) {
+            throw std::overflow_error("Matrix is too large for the CSR index type");
+        }
+        return static_cast<Index>(value);
+    }
+    
+    bool rowIsDirty(size_t row) const {
+        return !rowUpdates.empty() && !rowUpdates[row].empty();
+    }
+    
+    // Запис буфера для (row, col) або nullptr; кожен стовпець у буфері рядка не більше одного разу
+    const std::pair<size_t, T>* findUpdate(size_t row, size_t col) const {
+        for (const auto& update : rowUpdates[row]) {
+            if (update.first == col) return &update;
+        }
+        return nullptr;
+    }
+    
+    size_t findStored(size_t row, size_t col) const {
+        auto first = colIndices.begin() + rowPointers[row];
+        auto last = colIndices.begin() + rowPointers[row + 1];
+        auto it = std::lower_bound(first, last, col);
+        return (it != last && *it == col) ? static_cast<size_t>(it - colIndices.begin()) : colIndices.size();
+    }
+    
+    // Операнд іншого формату перекладається в CSR, щоб ядра працювали лише з масивами
+    static const CSRSparseMatrix<T, Index>& asCSR(const SparseMatrix<T>& other, CSRSparseMatrix<T, Index>& storage) {
+        const CSRSparseMatrix<T, Index>* csr = dynamic_cast<const CSRSparseMatrix<T, Index>*>(&other);
+        if (csr) return *csr;
+        
+        const CSRSparseMatrix<T>* wide = dynamic_cast<const CSRSparseMatrix<T>*>(&other);
+        if (wide) {
+            storage = wide->template withIndexType<Index>();
+            return storage;
+        }
+        const CSRSparseMatrix<T, uint32_t>* narrow = dynamic_cast<const CSRSparseMatrix<T, uint32_t>*>(&other);
+        if (narrow) {
+            storage = narrow->template withIndexType<Index>();
+            return storage;
+        }
+        
+        const MapSparseMatrix<T>* map = dynamic_cast<const MapSparseMatrix<T>*>(&other);
+        if (map) {
+            storage = fromMap(*map);
+            return storage;
+        }
+        
+        storage = CSRSparseMatrix<T, Index>(other.getRows(), other.getCols(), other.getDefaultValue());
+        other.forEachNonZero([&](size_t i, size_t j, const T& value) {
+            storage.colIndices.push_back(static_cast<Index>(j));
+            storage.values.push_back(value);
+            ++storage.rowPointers[i + 1];
+        });
+        toIndex(storage.values.size());
+        for (size_t k = 0; k < storage.rows; ++k) {
+            storage.rowPointers[k + 1] += storage.rowPointers[k];
+        }
+        return storage;
+    }
+    
+    // Порожня матриця r x c, що зберігає ємність масивів для повторного заповнення
+    void reset(size_t r, size_t c, const T& defVal) {
+        toIndex(r);
+        toIndex(c);
+        rows = r;
+        cols = c;
+        defaultValue = defVal;
+        values.clear();
+        colIndices.clear();
+        rowPointers.assign(r + 1, 0);
+        rowUpdates.clear();
+        pendingUpdates = 0;
+        columnCache.reset();
+    }
+    
+    T rowDot(size_t row, const std::vector<T>& vec) const {
+        if (rowIsDirty(row)) return dirtyRowDot(row, vec);
+        if constexpr (std::is_same<T, double>::value || std::is_same<T, float>::value) {
+            if (simdGatherFits<Index>(cols)) {
+                return defaultValue + simdRowDot(values.data(), colIndices.data(),
+                                                 rowPointers[row], rowPointers[row + 1], vec.data());
+            }
+        }
+        T sum = defaultValue;
+        for (size_t j = rowPointers[row]; j < rowPointers[row + 1]; ++j) {
+            sum = sum + values[j] * vec[colIndices[j]];
+        }
+        return sum;
+    }
+    
+    // Рядок із незлитими змінами: збережені елементи, перекриті буфером, пропускаються
+    T dirtyRowDot(size_t row, const std::vector<T>& vec) const {
+        T sum = defaultValue;
+        for (size_t j = rowPointers[row]; j < rowPointers[row + 1]; ++j) {
+            if (!findUpdate(row, colIndices[j])) {
+                sum = sum + values[j] * vec[colIndices[j]];
+            }
+        }
+        for (const auto& update : rowUpdates[row]) {
+            if (update.second != defaultValue) {
+                sum = sum + update.second * vec[update.first];
+            }
+        }
+        return sum;
+    }
+    
+    // Алгоритм Густавсона: рядок результату накопичується у щільному акумуляторі,
+    // а список зачеплених стовпців дозволяє не проходити весь рядок.
+    // Рядки [begin, end) дописуються в outValues/outCols, rowEnds[i - begin] — кінець рядка i
+    // Робочі масиви живуть у потоці між викликами, щоб повторні множення не виділяли пам'ять
+    void multiplyRows(const CSRSparseMatrix<T, Index>& rhs, size_t begin, size_t end,
+                      std::vector<T>& outValues, std::vector<Index>& outCols, Index* rowEnds) const {
+        const size_t unmarked = std::numeric_limits<size_t>::max();
+        thread_local std::vector<T> accumulator;
+        thread_local std::vector<size_t> marker;
+        thread_local std::vector<size_t> touched;
+        accumulator.assign(rhs.cols, defaultValue);
+        marker.assign(rhs.cols, unmarked);
+        
+        for (size_t i = begin; i < end; ++i) {
+            touched.clear();
+            for (size_t a = rowPointers[i]; a < rowPointers[i + 1]; ++a) {
+                size_t k = colIndices[a];
+                const T& aik = values[a];
+                for (size_t b = rhs.rowPointers[k]; b < rhs.rowPointers[k + 1]; ++b) {
+                    size_t j = rhs.colIndices[b];
+                    if (marker[j] != i) {
+                        marker[j] = i;
+                        accumulator[j] = defaultValue;
+                        touched.push_back(j);
+                    }
+                    accumulator[j] = accumulator[j] + aik * rhs.values[b];
+                }
+            }
+            
+            std::sort(touched.begin(), touched.end());
+            for (size_t j : touched) {
+                if (accumulator[j] != defaultValue) {
+                    outCols.push_back(static_cast<Index>(j));
+                    outValues.push_back(accumulator[j]);
+                }
+            }
+            rowEnds[i - begin] = toIndex(outValues.size());
+        }
+    }
+    
 public:
     CSRSparseMatrix(size_t r = 0, size_t c = 0, const T& defVal = T())
         : SparseMatrix<T>(r, c, defVal) {
+        toIndex(r);
+        toIndex(c);
         rowPointers.resize(r + 1, 0);
     }
     
-    T get(size_t row, size_t col) const override {
-        if (row >= rows || col >= cols) {
-            throw std::out_of_range("Matrix index out of range");
+    // Збирання з трійок (рядок, стовпець, значення): сортування за позицією,
+    // повторні позиції підсумовуються, значення за замовчуванням відкидаються
+    static CSRSparseMatrix<T, Index> fromTriplets(size_t r, size_t c,
+                                           std::vector<std::tuple<size_t, size_t, T>> triplets,
+                                           const T& defVal = T()) {
+        for (const auto& t : triplets) {
+            if (std::get<0>(t) >= r || std::get<1>(t) >= c) {
+                throw std::out_of_range("Matrix index out of range");
+            }
         }
         
-        size_t start = rowPointers[row];
-        size_t end = rowPointers[row + 1];
+        std::stable_sort(triplets.begin(), triplets.end(),
+            [](const std::tuple<size_t, size_t, T>& a, const std::tuple<size_t, size_t, T>& b) {
+                return std::get<0>(a) != std::get<0>(b) ? std::get<0>(a) < std::get<0>(b)
+                                                        : std::get<1>(a) < std::get<1>(b);
+            });
         
-        for (size_t i = start; i < end; ++i) {
-            if (colIndices[i] == col) {
-                return values[i];
+        CSRSparseMatrix<T, Index> result(r, c, defVal);
+        result.values.reserve(triplets.size());
+        result.colIndices.reserve(triplets.size());
+        
+        size_t i = 0;
+        while (i < triplets.size()) {
+            size_t row = std::get<0>(triplets[i]);
+            size_t col = std::get<1>(triplets[i]);
+            T sum = std::get<2>(triplets[i]);
+            for (++i; i < triplets.size() && std::get<0>(triplets[i]) == row
+                                          && std::get<1>(triplets[i]) == col; ++i) {
+                sum = sum + std::get<2>(triplets[i]);
+            }
+            if (sum != defVal) {
+                result.colIndices.push_back(static_cast<Index>(col));
+                result.values.push_back(sum);
+                ++result.rowPointers[row + 1];
             }
         }
+        toIndex(result.values.size());
+        for (size_t k = 0; k < r; ++k) {
+            result.rowPointers[k + 1] += result.rowPointers[k];
+        }
+        
+        return result;
+    }
+    
+    // Прийом готових масивів CSR без копіювання; рядки мають бути відсортовані за стовпцями
+    static CSRSparseMatrix<T, Index> fromArrays(size_t r, size_t c, std::vector<Index> rowPtrs,
+                                                std::vector<Index> cols, std::vector<T> vals,
+                                                const T& defVal = T()) {
+        if (rowPtrs.size() != r + 1 || cols.size() != vals.size()
+            || rowPtrs.front() != 0 || rowPtrs.back() != vals.size()) {
+            throw std::invalid_argument("Inconsistent CSR arrays");
+        }
+        toIndex(c);
+        
+        CSRSparseMatrix<T, Index> result(0, 0, defVal);
+        result.rows = r;
+        result.cols = c;
+        result.rowPointers = std::move(rowPtrs);
+        result.colIndices = std::move(cols);
+        result.values = std::move(vals);
+        return result;
+    }
+    
+    static CSRSparseMatrix<T, Index> fromMap(const MapSparseMatrix<T>& matrix) {
+        CSRSparseMatrix<T, Index> result(matrix.rows, matrix.cols, matrix.defaultValue);
+        toIndex(matrix.data.size());
+        result.values.reserve(matrix.data.size());
+        result.colIndices.reserve(matrix.data.size());
+        
+        for (const auto& entry : matrix.data) {
+            result.colIndices.push_back(static_cast<Index>(entry.first.second));
+            result.values.push_back(entry.second);
+            ++result.rowPointers[entry.first.first + 1];
+        }
+        for (size_t k = 0; k < matrix.rows; ++k) {
+            result.rowPointers[k + 1] += result.rowPointers[k];
+        }
+        
+        return result;
+    }
+    
+    void forEachNonZero(const std::function<void(size_t, size_t, const T&)>& visit) const override {
+        compact();
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = rowPointers[i]; j < rowPointers[i + 1]; ++j) {
+                if (values[j] != defaultValue) visit(i, colIndices[j], values[j]);
+            }
+        }
+    }
+    
+    MapSparseMatrix<T> toMap() const {
+        compact();
+        MapSparseMatrix<T> result(rows, cols, defaultValue);
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = rowPointers[i]; j < rowPointers[i + 1]; ++j) {
+                result.data.emplace_hint(result.data.end(), std::make_pair(i, colIndices[j]), values[j]);
+            }
+        }
+        return result;
+    }
+    
+    const std::vector<T>& getValues() const { compact(); return values; }
+    const std::vector<Index>& getColIndices() const { compact(); return colIndices; }
+    const std::vector<Index>& getRowPointers() const { compact(); return rowPointers; }
+    
+    // Копія з іншим типом індексів; звуження перевіряє, що розміри і nnz вміщуються
+    template<typename NewIndex>
+    CSRSparseMatrix<T, NewIndex> withIndexType() const {
+        compact();
+        CSRSparseMatrix<T, NewIndex> result(0, 0, defaultValue);
+        CSRSparseMatrix<T, NewIndex>::toIndex(rows);
+        CSRSparseMatrix<T, NewIndex>::toIndex(cols);
+        CSRSparseMatrix<T, NewIndex>::toIndex(values.size());
+        result.rows = rows;
+        result.cols = cols;
+        result.values = values;
+        result.colIndices.assign(colIndices.begin(), colIndices.end());
+        result.rowPointers.assign(rowPointers.begin(), rowPointers.end());
+        return result;
+    }
+    
+    // Байти, зайняті масивами індексів (без буфера змін)
+    size_t indexBytes() const {
+        return (colIndices.size() + rowPointers.size()) * sizeof(Index);
+    }
+    
+    // Зливає буфер змін з масивами за один прохід; рядки без змін копіюються цілком
+    void compact() const {
+        if (pendingUpdates == 0) return;
+        
+        std::vector<T> mergedValues;
+        std::vector<Index> mergedCols;
+        std::vector<Index> mergedRowPointers(rows + 1, 0);
+        mergedValues.reserve(values.size() + pendingUpdates);
+        mergedCols.reserve(values.size() + pendingUpdates);
+        
+        for (size_t i = 0; i < rows; ++i) {
+            size_t a = rowPointers[i], aEnd = rowPointers[i + 1];
+            std::vector<std::pair<size_t, T>>& updates = rowUpdates[i];
+            std::sort(updates.begin(), updates.end(),
+                [](const std::pair<size_t, T>& x, const std::pair<size_t, T>& y) { return x.first < y.first; });
+            
+            size_t b = 0;
+            while (a < aEnd || b < updates.size()) {
+                if (b == updates.size() || (a < aEnd && colIndices[a] < updates[b].first)) {
+                    mergedCols.push_back(colIndices[a]);
+                    mergedValues.push_back(values[a]);
+                    ++a;
+                    continue;
+                }
+                if (a < aEnd && colIndices[a] == updates[b].first) ++a;
+                if (updates[b].second != defaultValue) {
+                    mergedCols.push_back(static_cast<Index>(updates[b].first));
+                    mergedValues.push_back(updates[b].second);
+                }
+                ++b;
+            }
+            mergedRowPointers[i + 1] = toIndex(mergedValues.size());
+        }
+        
+        values.swap(mergedValues);
+        colIndices.swap(mergedCols);
+        rowPointers.swap(mergedRowPointers);
+        rowUpdates.clear();
+        pendingUpdates = 0;
+    }
+    
+    // Частка від nnz, після якої буфер змін зливається автоматично
+    void setCompactionRatio(double ratio) {
+        if (!(ratio > 0)) throw std::invalid_argument("Compaction ratio must be positive");
+        compactionRatio = ratio;
+    }
+    
+    size_t pendingUpdateCount() const {
+        return pendingUpdates;
+    }
+    
+    T get(size_t row, size_t col) const override {
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("Matrix index out of range");
+        }
         
-        return defaultValue;
+        if (rowIsDirty(row)) {
+            const std::pair<size_t, T>* update = findUpdate(row, col);
+            if (update) return update->second;
+        }
+        size_t pos = findStored(row, col);
+        return (pos != colIndices.size()) ? values[pos] : defaultValue;
     }
     
+    // Зміна наявного елемента пишеться прямо в масив; нова позиція або видалення
+    // потрапляють у буфер рядка до наступного compact()
     void set(size_t row, size_t col, const T& value) override {
-        throw std::runtime_error("CSR set not implemented - use for read-only operations");
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("Matrix index out of range");
+        }
+        
+        columnCache.reset();
+        size_t pos = findStored(row, col);
+        if (rowIsDirty(row)) {
+            std::vector<std::pair<size_t, T>>& updates = rowUpdates[row];
+            for (size_t k = 0; k < updates.size(); ++k) {
+                if (updates[k].first != col) continue;
+                if (pos != colIndices.size() && value != defaultValue) {
+                    values[pos] = value;
+                } else if (pos != colIndices.size() || value != defaultValue) {
+                    updates[k].second = value;
+                    return;
+                }
+                updates[k] = updates.back();
+                updates.pop_back();
+                --pendingUpdates;
+                return;
+            }
+        }
+        
+        if (pos != colIndices.size() && value != defaultValue) {
+            values[pos] = value;
+            return;
+        }
+        if (pos == colIndices.size() && value == defaultValue) {
+            return;
+        }
+        
+        if (rowUpdates.empty()) rowUpdates.resize(rows);
+        rowUpdates[row].emplace_back(col, value);
+        ++pendingUpdates;
+        if (pendingUpdates > std::max<size_t>(64, static_cast<size_t>(compactionRatio * values.size()))) {
+            compact();
+        }
     }
     
     size_t nonZeroCount() const override {
+        compact();
         return values.size();
     }
     
     std::string toString() const override {
+        compact();
         std::ostringstream oss;
         oss << "CSRSparseMatrix[" << rows << "x" << cols << ", stored=" << values.size() << "]";
         return oss.str();
@@ -271,44 +848,350 @@ public:
         values.clear();
         colIndices.clear();
         rowPointers.assign(rows + 1, 0);
+        rowUpdates.clear();
+        pendingUpdates = 0;
+        columnCache.reset();
     }
     
     SparseMatrix<T>* add(const SparseMatrix<T>& other) const override {
-        throw std::runtime_error("CSR operations not fully implemented");
+        return new CSRSparseMatrix<T, Index>(added(other));
+    }
+    
+    CSRSparseMatrix<T, Index> added(const SparseMatrix<T>& other) const {
+        CSRSparseMatrix<T, Index> result;
+        addInto(other, result);
+        return result;
+    }
+    
+    // Сума в наявну матрицю result: її масиви очищаються, але ємність зберігається,
+    // тож у циклі з однаковими шаблонами заповнення пам'ять не виділяється
+    void addInto(const SparseMatrix<T>& other, CSRSparseMatrix<T, Index>& result) const {
+        if (rows != other.getRows() || cols != other.getCols()) {
+            throw std::invalid_argument("Matrix dimensions must match for addition");
+        }
+        if (&result == this || &result == &other) {
+            throw std::invalid_argument("Result matrix must not alias an operand");
+        }
+        
+        const CSRSparseMatrix<T, Index>* csr = dynamic_cast<const CSRSparseMatrix<T, Index>*>(&other);
+        if (!csr) {
+            CSRSparseMatrix<T, Index> converted;
+            addInto(asCSR(other, converted), result);
+            return;
+        }
+        const CSRSparseMatrix<T, Index>& rhs = *csr;
+        compact();
+        rhs.compact();
+        
+        result.reset(rows, cols, defaultValue);
+        result.values.reserve(values.size() + rhs.values.size());
+        result.colIndices.reserve(values.size() + rhs.values.size());
+        
+        for (size_t i = 0; i < rows; ++i) {
+            size_t a = rowPointers[i], aEnd = rowPointers[i + 1];
+            size_t b = rhs.rowPointers[i], bEnd = rhs.rowPointers[i + 1];
+            
+            while (a < aEnd || b < bEnd) {
+                size_t col;
+                T sum;
+                if (b == bEnd || (a < aEnd && colIndices[a] < rhs.colIndices[b])) {
+                    col = colIndices[a];
+                    sum = values[a++] + rhs.defaultValue;
+                } else if (a == aEnd || rhs.colIndices[b] < colIndices[a]) {
+                    col = rhs.colIndices[b];
+                    sum = defaultValue + rhs.values[b++];
+                } else {
+                    col = colIndices[a];
+                    sum = values[a++] + rhs.values[b++];
+                }
+                if (sum != defaultValue) {
+                    result.colIndices.push_back(static_cast<Index>(col));
+                    result.values.push_back(sum);
+                }
+            }
+            result.rowPointers[i + 1] = toIndex(result.values.size());
+        }
     }
     
     SparseMatrix<T>* multiply(const SparseMatrix<T>& other) const override {
-        throw std::runtime_error("CSR operations not fully implemented");
+        return new CSRSparseMatrix<T, Index>(multiplied(other));
+    }
+    
+    CSRSparseMatrix<T, Index> multiplied(const SparseMatrix<T>& other) const {
+        CSRSparseMatrix<T, Index> result;
+        multiplyInto(other, result);
+        return result;
+    }
+    
+    void multiplyInto(const SparseMatrix<T>& other, CSRSparseMatrix<T, Index>& result) const {
+        if (cols != other.getRows()) {
+            throw std::invalid_argument("Invalid dimensions for matrix multiplication");
+        }
+        if (&result == this || &result == &other) {
+            throw std::invalid_argument("Result matrix must not alias an operand");
+        }
+        
+        const CSRSparseMatrix<T, Index>* csr = dynamic_cast<const CSRSparseMatrix<T, Index>*>(&other);
+        if (!csr) {
+            CSRSparseMatrix<T, Index> converted;
+            multiplyInto(asCSR(other, converted), result);
+            return;
+        }
+        const CSRSparseMatrix<T, Index>& rhs = *csr;
+        compact();
+        rhs.compact();
+        
+        result.reset(rows, rhs.cols, defaultValue);
+        multiplyRows(rhs, 0, rows, result.values, result.colIndices, result.rowPointers.data() + 1);
+    }
+    
+    // Рядки розподіляються між потоками за кількістю ненульових елементів;
+    // кожен рядок рахується тим самим ядром, тому результат побітово збігається з multiply
+    CSRSparseMatrix<T, Index> multiplyParallel(const CSRSparseMatrix<T, Index>& other,
+                                        ThreadPool& pool = ThreadPool::shared()) const {
+        if (cols != other.rows) {
+            throw std::invalid_argument("Invalid dimensions for matrix multiplication");
+        }
+        compact();
+        other.compact();
+        
+        std::vector<size_t> bounds = partitionRows(pool.size());
+        size_t parts = bounds.size() - 1;
+        std::vector<std::vector<T>> partValues(parts);
+        std::vector<std::vector<Index>> partCols(parts);
+        
+        CSRSparseMatrix<T, Index> result(rows, other.cols, defaultValue);
+        pool.parallelFor(parts, [&](size_t p) {
+            multiplyRows(other, bounds[p], bounds[p + 1], partValues[p], partCols[p],
+                         result.rowPointers.data() + bounds[p] + 1);
+        });
+        
+        size_t offset = 0;
+        for (size_t p = 0; p < parts; ++p) {
+            for (size_t i = bounds[p]; i < bounds[p + 1]; ++i) {
+                result.rowPointers[i + 1] = toIndex(result.rowPointers[i + 1] + offset);
+            }
+            offset += partValues[p].size();
+        }
+        result.values.reserve(offset);
+        result.colIndices.reserve(offset);
+        for (size_t p = 0; p < parts; ++p) {
+            result.values.insert(result.values.end(), partValues[p].begin(), partValues[p].end());
+            result.colIndices.insert(result.colIndices.end(), partCols[p].begin(), partCols[p].end());
+        }
+        
+        return result;
     }
     
     std::vector<T> multiplyVector(const std::vector<T>& vec) const override {
+        std::vector<T> result;
+        multiplyVector(vec, result);
+        return result;
+    }
+    
+    void multiplyVector(const std::vector<T>& vec, std::vector<T>& result) const override {
+        if (cols != vec.size()) {
+            throw std::invalid_argument("Vector size must match matrix columns");
+        }
+        if (&vec == &result) {
+            throw std::invalid_argument("Result vector must not alias the input");
+        }
+        
+        result.resize(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            result[i] = rowDot(i, vec);
+        }
+    }
+    
+    std::vector<T> multiplyVectorParallel(const std::vector<T>& vec,
+                                          ThreadPool& pool = ThreadPool::shared()) const {
         if (cols != vec.size()) {
             throw std::invalid_argument("Vector size must match matrix columns");
         }
         
         std::vector<T> result(rows, defaultValue);
+        std::vector<size_t> bounds = partitionRows(pool.size());
+        pool.parallelFor(bounds.size() - 1, [&](size_t p) {
+            for (size_t i = bounds[p]; i < bounds[p + 1]; ++i) {
+                result[i] = rowDot(i, vec);
+            }
+        });
+        
+        return result;
+    }
+    
+    // Межі parts діапазонів рядків із приблизно однаковою кількістю ненульових елементів
+    std::vector<size_t> partitionRows(size_t parts) const {
+        parts = std::max<size_t>(1, std::min(parts, std::max<size_t>(rows, 1)));
+        std::vector<size_t> bounds(parts + 1, rows);
+        bounds[0] = 0;
+        
+        size_t nnz = values.size();
+        for (size_t p = 1; p < parts; ++p) {
+            if (nnz == 0) {
+                bounds[p] = rows * p / parts;
+                continue;
+            }
+            size_t target = nnz * p / parts;
+            size_t row = std::lower_bound(rowPointers.begin(), rowPointers.end(), target) - rowPointers.begin();
+            bounds[p] = std::max(bounds[p - 1], std::min(row, rows));
+        }
+        
+        return bounds;
+    }
+    
+    // Транспонування підрахунком: рядки результату виходять вже відсортованими
+    SparseMatrix<T>* transpose() const override {
+        return new CSRSparseMatrix<T, Index>(transposed());
+    }
+    
+    CSRSparseMatrix<T, Index> transposed() const {
+        CSRSparseMatrix<T, Index> result;
+        transposeInto(result);
+        return result;
+    }
+    
+    // Початки рядків результату служать курсорами заповнення і після проходу
+    // зсуваються на місце, тому додаткового масиву не потрібно
+    void transposeInto(CSRSparseMatrix<T, Index>& result) const {
+        if (&result == this) {
+            throw std::invalid_argument("Result matrix must not alias an operand");
+        }
+        
+        compact();
+        result.reset(cols, rows, defaultValue);
+        result.values.resize(values.size());
+        result.colIndices.resize(values.size());
+        
+        for (size_t c : colIndices) {
+            ++result.rowPointers[c + 1];
+        }
+        for (size_t c = 0; c < cols; ++c) {
+            result.rowPointers[c + 1] += result.rowPointers[c];
+        }
+        
         for (size_t i = 0; i < rows; ++i) {
-            T sum = defaultValue;
-            size_t start = rowPointers[i];
-            size_t end = rowPointers[i + 1];
-            
-            for (size_t j = start; j < end; ++j) {
-                sum = sum + values[j] * vec[colIndices[j]];
+            for (size_t j = rowPointers[i]; j < rowPointers[i + 1]; ++j) {
+                size_t pos = result.rowPointers[colIndices[j]]++;
+                result.colIndices[pos] = static_cast<Index>(i);
+                result.values[pos] = values[j];
             }
-            result[i] = sum;
+        }
+        for (size_t c = cols; c > 0; --c) {
+            result.rowPointers[c] = result.rowPointers[c - 1];
+        }
+        result.rowPointers[0] = 0;
+    }
+    
+    // Вікно рядків [begin, end) без копіювання; дійсне, доки матриця не змінюється
+    CSRRowView<T, Index> rowRange(size_t begin, size_t end) const {
+        return CSRRowView<T, Index>(*this, begin, end);
+    }
+    
+    // Та сама матриця у стовпцевому порядку (CSC як CSR транспонованої).
+    // Будується при першому зверненні й скидається при будь-якій зміні матриці
+    const CSRSparseMatrix<T, Index>& columnMajor() const {
+        if (!columnCache) {
+            std::shared_ptr<CSRSparseMatrix<T, Index>> transposed = std::make_shared<CSRSparseMatrix<T, Index>>();
+            transposeInto(*transposed);
+            columnCache = transposed;
+        }
+        return *columnCache;
+    }
+    
+    // Стовпці [begin, end): зріз CSC переписується назад у рядки підрахунком, O(rows + nnz зрізу)
+    CSRSparseMatrix<T, Index> columnRange(size_t begin, size_t end) const {
+        if (begin > end || end > cols) {
+            throw std::out_of_range("Column range out of bounds");
         }
         
+        const CSRSparseMatrix<T, Index>& csc = columnMajor();
+        size_t first = csc.rowPointers[begin], last = csc.rowPointers[end];
+        CSRSparseMatrix<T, Index> result(rows, end - begin, defaultValue);
+        result.values.resize(last - first);
+        result.colIndices.resize(last - first);
+        
+        for (size_t k = first; k < last; ++k) {
+            ++result.rowPointers[csc.colIndices[k] + 1];
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            result.rowPointers[i + 1] += result.rowPointers[i];
+        }
+        
+        std::vector<size_t> next(result.rowPointers.begin(), result.rowPointers.end() - 1);
+        for (size_t c = begin; c < end; ++c) {
+            for (size_t k = csc.rowPointers[c]; k < csc.rowPointers[c + 1]; ++k) {
+                size_t pos = next[csc.colIndices[k]]++;
+                result.colIndices[pos] = static_cast<Index>(c - begin);
+                result.values[pos] = csc.values[k];
+            }
+        }
         return result;
     }
     
-    SparseMatrix<T>* transpose() const override {
-        throw std::runtime_error("CSR transpose not implemented");
+    // Прямокутний блок: у кожному рядку межі стовпців шукаються двійковим пошуком
+    CSRSparseMatrix<T, Index> block(size_t rowBegin, size_t rowEnd, size_t colBegin, size_t colEnd) const {
+        if (rowBegin > rowEnd || rowEnd > rows || colBegin > colEnd || colEnd > cols) {
+            throw std::out_of_range("Block out of bounds");
+        }
+        
+        compact();
+        CSRSparseMatrix<T, Index> result(rowEnd - rowBegin, colEnd - colBegin, defaultValue);
+        for (size_t i = rowBegin; i < rowEnd; ++i) {
+            auto rowFirst = colIndices.begin() + rowPointers[i];
+            auto rowLast = colIndices.begin() + rowPointers[i + 1];
+            size_t a = std::lower_bound(rowFirst, rowLast, colBegin) - colIndices.begin();
+            size_t b = std::lower_bound(rowFirst, rowLast, colEnd) - colIndices.begin();
+            for (size_t j = a; j < b; ++j) {
+                result.colIndices.push_back(static_cast<Index>(colIndices[j] - colBegin));
+                result.values.push_back(values[j]);
+            }
+            result.rowPointers[i - rowBegin + 1] = toIndex(result.values.size());
+        }
+        return result;
+    }
+    
+    // Підматриця за довільними наборами індексів: result[a][b] = A[rowSet[a]][colSet[b]].
+    // Набір стовпців сортується один раз, тож вартість не залежить від загальної кількості стовпців
+    CSRSparseMatrix<T, Index> submatrix(const std::vector<size_t>& rowSet, const std::vector<size_t>& colSet) const {
+        std::vector<std::pair<size_t, size_t>> colLookup(colSet.size());
+        for (size_t b = 0; b < colSet.size(); ++b) {
+            if (colSet[b] >= cols) throw std::out_of_range("Matrix index out of range");
+            colLookup[b] = std::make_pair(colSet[b], b);
+        }
+        std::sort(colLookup.begin(), colLookup.end());
+        
+        compact();
+        CSRSparseMatrix<T, Index> result(rowSet.size(), colSet.size(), defaultValue);
+        std::vector<std::pair<size_t, T>> row;
+        for (size_t a = 0; a < rowSet.size(); ++a) {
+            size_t i = rowSet[a];
+            if (i >= rows) throw std::out_of_range("Matrix index out of range");
+            
+            row.clear();
+            auto lookup = colLookup.begin();
+            for (size_t j = rowPointers[i]; j < rowPointers[i + 1] && lookup != colLookup.end(); ++j) {
+                lookup = std::lower_bound(lookup, colLookup.end(), std::make_pair(colIndices[j], size_t(0)));
+                for (auto it = lookup; it != colLookup.end() && it->first == colIndices[j]; ++it) {
+                    row.emplace_back(it->second, values[j]);
+                }
+            }
+            std::sort(row.begin(), row.end(),
+                [](const std::pair<size_t, T>& x, const std::pair<size_t, T>& y) { return x.first < y.first; });
+            for (const auto& entry : row) {
+                result.colIndices.push_back(static_cast<Index>(entry.first));
+                result.values.push_back(entry.second);
+            }
+            result.rowPointers[a + 1] = toIndex(result.values.size());
+        }
+        return result;
     }
     
     void saveToFile(const std::string& filename) const override {
         std::ofstream out(filename);
         if (!out) throw std::runtime_error("Cannot open file for writing");
         
+        compact();
         out << "CSRSparseMatrix\n";
         out << rows << " " << cols << "\n";
         out << values.size() << "\n";
@@ -331,9 +1214,15 @@ public:
         
         size_t r, c, count;
         in >> r >> c >> count;
+        toIndex(r);
+        toIndex(c);
+        toIndex(count);
         
         rows = r;
         cols = c;
+        rowUpdates.clear();
+        pendingUpdates = 0;
+        columnCache.reset();
         
         values.resize(count);
         colIndices.resize(count);
@@ -343,6 +1232,130 @@ public:
         for (size_t i = 0; i < count; ++i) in >> colIndices[i];
         for (size_t i = 0; i < r + 1; ++i) in >> rowPointers[i];
     }
+    
+    void saveBinary(const std::string& filename) const {
+        static_assert(std::is_trivially_copyable<T>::value, "Binary format requires trivially copyable values");
+        
+        compact();
+        SparseBinaryWriter writer(filename, SparseBinaryKind::CSRMatrix, rows, cols, values.size(), sizeof(T));
+        writer.writeArray(&defaultValue, sizeof(T));
+        writer.writeIndices(rowPointers.data(), rowPointers.size());
+        writer.writeIndices(colIndices.data(), colIndices.size());
+        writer.writeArray(values.data(), values.size() * sizeof(T));
+        writer.finish();
+    }
+    
+    void loadBinary(const std::string& filename) {
+        static_assert(std::is_trivially_copyable<T>::value, "Binary format requires trivially copyable values");
+        
+        SparseBinaryReader reader(filename, SparseBinaryKind::CSRMatrix, sizeof(T));
+        const SparseBinaryHeader& header = reader.getHeader();
+        
+        CSRSparseMatrix<T, Index> loaded(header.rows, header.cols);
+        toIndex(header.nonZeros);
+        loaded.values.resize(header.nonZeros);
+        loaded.colIndices.resize(header.nonZeros);
+        reader.readArray(&loaded.defaultValue, sizeof(T));
+        reader.readIndices(loaded.rowPointers.data(), loaded.rowPointers.size());
+        reader.readIndices(loaded.colIndices.data(), loaded.colIndices.size());
+        reader.readArray(loaded.values.data(), loaded.values.size() * sizeof(T));
+        reader.verify();
+        
+        if (!sparseBinaryValidCSR(loaded.rowPointers.data(), loaded.colIndices.data(),
+                                  header.rows, header.cols, header.nonZeros)) {
+            throw std::runtime_error("Invalid file format");
+        }
+        *this = std::move(loaded);
+    }
+};
+
+// Вікно рядків CSR-матриці: вказівники прямо в масиви джерела, нічого не копіюється.
+// Дійсне, доки матриця-джерело існує і не змінюється
+template<typename T, typename Index>
+class CSRRowView {
+private:
+    const T* values;
+    const Index* colIndices;
+    const Index* rowPointers;
+    size_t rows, cols, firstRow;
+    T defaultValue;
+    
+public:
+    CSRRowView(const CSRSparseMatrix<T, Index>& matrix, size_t begin, size_t end)
+        : rows(end - begin), cols(matrix.getCols()), firstRow(begin), defaultValue(matrix.getDefaultValue()) {
+        if (begin > end || end > matrix.getRows()) {
+            throw std::out_of_range("Row range out of bounds");
+        }
+        values = matrix.getValues().data();
+        colIndices = matrix.getColIndices().data();
+        rowPointers = matrix.getRowPointers().data() + begin;
+    }
+    
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+    size_t getFirstRow() const { return firstRow; }
+    const T& getDefaultValue() const { return defaultValue; }
+    size_t nonZeroCount() const { return rowPointers[rows] - rowPointers[0]; }
+    
+    T get(size_t row, size_t col) const {
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("Matrix index out of range");
+        }
+        const Index* first = colIndices + rowPointers[row];
+        const Index* last = colIndices + rowPointers[row + 1];
+        const Index* it = std::lower_bound(first, last, col);
+        return (it != last && *it == col) ? values[it - colIndices] : defaultValue;
+    }
+    
+    void multiplyVector(const std::vector<T>& vec, std::vector<T>& result) const {
+        if (cols != vec.size()) {
+            throw std::invalid_argument("Vector size must match matrix columns");
+        }
+        
+        result.resize(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            if constexpr (std::is_same<T, double>::value || std::is_same<T, float>::value) {
+                if (simdGatherFits<Index>(cols)) {
+                    result[i] = defaultValue + simdRowDot(values, colIndices, rowPointers[i], rowPointers[i + 1], vec.data());
+                    continue;
+                }
+            }
+            T sum = defaultValue;
+            for (size_t j = rowPointers[i]; j < rowPointers[i + 1]; ++j) {
+                sum = sum + values[j] * vec[colIndices[j]];
+            }
+            result[i] = sum;
+        }
+    }
+    
+    std::vector<T> multiplyVector(const std::vector<T>& vec) const {
+        std::vector<T> result;
+        multiplyVector(vec, result);
+        return result;
+    }
+    
+    CSRSparseMatrix<T, Index> toCSR() const {
+        size_t offset = rowPointers[0];
+        std::vector<Index> rowPtrs(rows + 1);
+        for (size_t i = 0; i <= rows; ++i) {
+            rowPtrs[i] = static_cast<Index>(rowPointers[i] - offset);
+        }
+        return CSRSparseMatrix<T, Index>::fromArrays(rows, cols, std::move(rowPtrs),
+            std::vector<Index>(colIndices + offset, colIndices + rowPointers[rows]),
+            std::vector<T>(values + offset, values + rowPointers[rows]), defaultValue);
+    }
+    
+    std::string toString() const {
+        std::ostringstream oss;
+        oss << "CSRRowView[" << rows << "x" << cols << " from row " << firstRow
+            << ", stored=" << nonZeroCount() << "]";
+        return oss.str();
+    }
 };
 
+template<typename T>
+CSRSparseMatrix<T> MapSparseMatrix<T>::toCSR() const {
+    return CSRSparseMatrix<T>::fromMap(*this);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,442 @@
+#ifndef SPARSEMATRIXLOADER_H
+#define SPARSEMATRIXLOADER_H
+
+#include "SparseMatrix.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <limits>
+#include <cstdlib>
+#include <cctype>
+#include <type_traits>
+
+struct SparseLoadOptions {
+    size_t chunkSize = size_t(1) << 20;
+    bool backgroundRead = true;
+    size_t rowBegin = 0;
+    size_t rowEnd = std::numeric_limits<size_t>::max();
+    size_t blockEntries = size_t(1) << 16;
+};
+
+// Читає файл шматками фіксованого розміру; у фоновому режимі наступний шматок
+// читається окремим потоком, поки попередній розбирається
+class ChunkedFileReader {
+private:
+    std::ifstream in;
+    size_t chunkSize;
+    bool background;
+    
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::string> ready;
+    bool finished = false;
+    bool cancelled = false;
+    std::exception_ptr error;
+    
+    bool readChunk(std::string& chunk) {
+        chunk.resize(chunkSize);
+        in.read(&chunk[0], static_cast<std::streamsize>(chunkSize));
+        chunk.resize(static_cast<size_t>(in.gcount()));
+        return !chunk.empty();
+    }
+    
+    void workerLoop() {
+        try {
+            while (true) {
+                std::string chunk;
+                if (!readChunk(chunk)) break;
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [this]() { return cancelled || ready.size() < 2; });
+                if (cancelled) return;
+                ready.push_back(std::move(chunk));
+                changed.notify_all();
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+        changed.notify_all();
+    }
+    
+public:
+    ChunkedFileReader(const std::string& filename, size_t chunk, bool backgroundRead)
+        : in(filename, std::ios::binary), chunkSize(chunk == 0 ? 1 : chunk), background(backgroundRead) {
+        if (!in) throw std::runtime_error("Cannot open file for reading");
+        if (background) {
+            worker = std::thread([this]() { workerLoop(); });
+        }
+    }
+    
+    ChunkedFileReader(const ChunkedFileReader&) = delete;
+    ChunkedFileReader& operator=(const ChunkedFileReader&) = delete;
+    
+    ~ChunkedFileReader() {
+        if (worker.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                cancelled = true;
+            }
+            changed.notify_all();
+            worker.join();
+        }
+    }
+    
+    bool next(std::string& chunk) {
+        if (!background) return readChunk(chunk);
+        
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]() { return finished || !ready.empty(); });
+        if (!ready.empty()) {
+            chunk = std::move(ready.front());
+            ready.pop_front();
+            changed.notify_all();
+            return true;
+        }
+        if (error) std::rethrow_exception(error);
+        return false;
+    }
+};
+
+// Потокове завантаження у CSR. Підтримуються текстовий формат MapSparseMatrix::saveToFile
+// та координатний MatrixMarket (real/integer/pattern, general/symmetric/skew-symmetric).
+// Рядки з [rowBegin, rowEnd) потрапляють у результат зі зсувом на rowBegin.
+// Поки вхід впорядкований за рядками, завершені рядки одразу дописуються в масиви CSR
+// блоками по blockEntries. Невпорядкований вхід (а симетричний MatrixMarket — одразу)
+// читається ще двічі: спершу рахуються записи кожного рядка, потім записи кладуться
+// прямо на свої місця в CSR, тож у пам'яті ніколи немає нічого, крім самих масивів CSR
+template<typename T>
+class SparseMatrixLoader {
+private:
+    enum class Format { Unknown, MapText, MatrixMarket };
+    enum class Symmetry { General, Symmetric, SkewSymmetric };
+    enum class Pass { Stream, Count, Fill };
+    
+    SparseLoadOptions options;
+    T defaultValue;
+    
+    Format format = Format::Unknown;
+    Symmetry symmetry = Symmetry::General;
+    bool pattern = false;
+    bool sizeKnown = false;
+    bool countSeen = false;
+    size_t rows = 0, cols = 0;
+    size_t firstRow = 0, lastRow = 0;
+    
+    Pass pass = Pass::Stream;
+    bool restart = false;
+    size_t committedRows = 0;
+    std::vector<std::tuple<size_t, size_t, T>> pending;
+    std::vector<size_t> rowPointers;
+    std::vector<size_t> colIndices;
+    std::vector<T> values;
+    std::vector<size_t> rowFill;
+    
+    static bool nextToken(const char*& cursor, const char* end, const char*& tokenBegin, const char*& tokenEnd) {
+        while (cursor < end && std::isspace(static_cast<unsigned char>(*cursor))) ++cursor;
+        tokenBegin = cursor;
+        while (cursor < end && !std::isspace(static_cast<unsigned char>(*cursor))) ++cursor;
+        tokenEnd = cursor;
+        return tokenEnd > tokenBegin;
+    }
+    
+    // Числа розбираються прямо з буфера шматка: токен завжди закінчується пробілом,
+    // переведенням рядка або нуль-термінатором, тому strto* не виходять за його межі
+    static size_t parseIndex(const char* begin, const char* end) {
+        char* stop = nullptr;
+        unsigned long long value = std::strtoull(begin, &stop, 10);
+        if (stop != end) throw std::runtime_error("Invalid index in matrix file");
+        return static_cast<size_t>(value);
+    }
+    
+    static T parseValue(const char* begin, const char* end) {
+        if constexpr (std::is_integral<T>::value) {
+            char* stop = nullptr;
+            long long value = std::strtoll(begin, &stop, 10);
+            if (stop != end) throw std::runtime_error("Invalid value in matrix file");
+            return static_cast<T>(value);
+        } else if constexpr (std::is_floating_point<T>::value) {
+            char* stop = nullptr;
+            double value = std::strtod(begin, &stop);
+            if (stop != end) throw std::runtime_error("Invalid value in matrix file");
+            return static_cast<T>(value);
+        } else {
+            std::istringstream iss(std::string(begin, end));
+            T value;
+            iss >> value;
+            return value;
+        }
+    }
+    
+    static std::vector<std::string> split(const char* begin, const char* end) {
+        std::vector<std::string> tokens;
+        const char* tokenBegin;
+        const char* tokenEnd;
+        while (nextToken(begin, end, tokenBegin, tokenEnd)) {
+            std::string token(tokenBegin, tokenEnd);
+            for (char& ch : token) ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+            tokens.push_back(token);
+        }
+        return tokens;
+    }
+    
+    // Дописує завершені рядки (< limit) з pending у масиви CSR. У потоковому режимі pending
+    // упорядкований за рядками, тож сортується лише префікс рядків, що дописуються
+    void commitRows(size_t limit) {
+        auto boundary = std::partition_point(pending.begin(), pending.end(),
+            [limit](const std::tuple<size_t, size_t, T>& entry) { return std::get<0>(entry) < limit; });
+        std::stable_sort(pending.begin(), boundary,
+            [](const std::tuple<size_t, size_t, T>& a, const std::tuple<size_t, size_t, T>& b) {
+                return std::get<0>(a) != std::get<0>(b) ? std::get<0>(a) < std::get<0>(b)
+                                                        : std::get<1>(a) < std::get<1>(b);
+            });
+        
+        size_t i = 0;
+        size_t count = static_cast<size_t>(boundary - pending.begin());
+        while (i < count) {
+            size_t row = std::get<0>(pending[i]);
+            size_t col = std::get<1>(pending[i]);
+            T sum = std::get<2>(pending[i]);
+            for (++i; i < count && std::get<0>(pending[i]) == row && std::get<1>(pending[i]) == col; ++i) {
+                sum = sum + std::get<2>(pending[i]);
+            }
+            while (committedRows < row) {
+                rowPointers.push_back(values.size());
+                ++committedRows;
+            }
+            if (sum != defaultValue) {
+                colIndices.push_back(col);
+                values.push_back(sum);
+            }
+        }
+        pending.erase(pending.begin(), pending.begin() + i);
+    }
+    
+    // Сортує кожен рядок за стовпцем, зводить повтори і прибирає значення за замовчуванням.
+    // Рядок лише стискається ліворуч, тож запис іде в ті самі масиви
+    void compactRows() {
+        std::vector<std::pair<size_t, T>> row;
+        size_t out = 0;
+        for (size_t i = 0; i + 1 < rowPointers.size(); ++i) {
+            row.clear();
+            for (size_t j = rowPointers[i]; j < rowPointers[i + 1]; ++j) {
+                row.emplace_back(colIndices[j], values[j]);
+            }
+            std::stable_sort(row.begin(), row.end(),
+                [](const std::pair<size_t, T>& a, const std::pair<size_t, T>& b) { return a.first < b.first; });
+            
+            rowPointers[i] = out;
+            size_t k = 0;
+            while (k < row.size()) {
+                size_t col = row[k].first;
+                T sum = row[k].second;
+                for (++k; k < row.size() && row[k].first == col; ++k) sum = sum + row[k].second;
+                if (sum != defaultValue) {
+                    colIndices[out] = col;
+                    values[out] = sum;
+                    ++out;
+                }
+            }
+        }
+        rowPointers.back() = out;
+        colIndices.resize(out);
+        values.resize(out);
+    }
+    
+    void addEntry(size_t row, size_t col, const T& value) {
+        if (row >= rows || col >= cols) throw std::out_of_range("Matrix index out of range");
+        if (row < firstRow || row >= lastRow) return;
+        
+        size_t local = row - firstRow;
+        if (pass == Pass::Count) {
+            ++rowPointers[local + 1];
+            return;
+        }
+        if (pass == Pass::Fill) {
+            if (rowFill[local] == rowPointers[local + 1]) throw std::runtime_error("Matrix file changed while loading");
+            size_t j = rowFill[local]++;
+            colIndices[j] = col;
+            values[j] = value;
+            return;
+        }
+        
+        if (local < committedRows || (!pending.empty() && local < std::get<0>(pending.back()))) {
+            // Вхід невпорядкований: уже зібране відкидається, файл перечитується з підрахунком
+            pass = Pass::Count;
+            restart = true;
+            std::vector<std::tuple<size_t, size_t, T>>().swap(pending);
+            std::vector<size_t>().swap(colIndices);
+            std::vector<T>().swap(values);
+            return;
+        }
+        pending.emplace_back(local, col, value);
+        
+        // Поточний рядок ще може продовжитися, тож блок дописується лише тоді, коли в ньому
+        // є завершені рядки: довгий рядок накопичується без повторних сортувань
+        if (pending.size() >= options.blockEntries && std::get<0>(pending.front()) < local) {
+            commitRows(local);
+        }
+    }
+    
+    void setSize(size_t r, size_t c) {
+        rows = r;
+        cols = c;
+        sizeKnown = true;
+        firstRow = std::min(options.rowBegin, rows);
+        lastRow = std::max(firstRow, std::min(options.rowEnd, rows));
+        if (pass == Pass::Stream) rowPointers.assign(1, 0);
+        if (pass == Pass::Count) rowPointers.assign(lastRow - firstRow + 1, 0);
+    }
+    
+    void parseHeader(const std::vector<std::string>& tokens) {
+        if (tokens[0] == "mapsparsematrix") {
+            format = Format::MapText;
+            return;
+        }
+        if (tokens[0] != "%%matrixmarket") throw std::runtime_error("Invalid file format");
+        if (tokens.size() < 5 || tokens[1] != "matrix" || tokens[2] != "coordinate") {
+            throw std::runtime_error("Only coordinate MatrixMarket files are supported");
+        }
+        format = Format::MatrixMarket;
+        if (tokens[3] == "pattern") {
+            pattern = true;
+        } else if (tokens[3] != "real" && tokens[3] != "integer" && tokens[3] != "double") {
+            throw std::runtime_error("Unsupported MatrixMarket field: " + tokens[3]);
+        }
+        if (tokens[4] == "symmetric") {
+            symmetry = Symmetry::Symmetric;
+        } else if (tokens[4] == "skew-symmetric") {
+            symmetry = Symmetry::SkewSymmetric;
+        } else if (tokens[4] != "general") {
+            throw std::runtime_error("Unsupported MatrixMarket symmetry: " + tokens[4]);
+        }
+        // Дзеркальні записи завжди порушують порядок рядків
+        if (symmetry != Symmetry::General && pass == Pass::Stream) pass = Pass::Count;
+    }
+    
+    void parseLine(const char* begin, const char* end) {
+        if (format == Format::MatrixMarket && begin < end && *begin == '%') return;
+        
+        if (format == Format::Unknown || !sizeKnown || (format == Format::MapText && !countSeen)) {
+            std::vector<std::string> tokens = split(begin, end);
+            if (tokens.empty()) return;
+            if (format == Format::Unknown) {
+                parseHeader(tokens);
+                return;
+            }
+            if (!sizeKnown) {
+                if (tokens.size() < (format == Format::MatrixMarket ? 3u : 2u)) {
+                    throw std::runtime_error("Invalid file format");
+                }
+                const std::string& r = tokens[0];
+                const std::string& c = tokens[1];
+                setSize(parseIndex(r.c_str(), r.c_str() + r.size()), parseIndex(c.c_str(), c.c_str() + c.size()));
+                countSeen = format == Format::MatrixMarket || tokens.size() > 2;
+            } else {
+                countSeen = true;
+            }
+            return;
+        }
+        
+        const char* tokens[3][2];
+        size_t count = 0;
+        while (count < 3 && nextToken(begin, end, tokens[count][0], tokens[count][1])) ++count;
+        if (count == 0) return;
+        
+        size_t needed = (format == Format::MatrixMarket && pattern) ? 2 : 3;
+        if (count < needed) throw std::runtime_error("Invalid matrix entry");
+        size_t row = parseIndex(tokens[0][0], tokens[0][1]);
+        size_t col = parseIndex(tokens[1][0], tokens[1][1]);
+        T value = needed == 2 ? T(1) : parseValue(tokens[2][0], tokens[2][1]);
+        
+        if (format == Format::MapText) {
+            addEntry(row, col, value);
+            return;
+        }
+        
+        if (row == 0 || col == 0) throw std::runtime_error("MatrixMarket indices are 1-based");
+        addEntry(row - 1, col - 1, value);
+        if (symmetry != Symmetry::General && row != col) {
+            addEntry(col - 1, row - 1, symmetry == Symmetry::SkewSymmetric ? T() - value : value);
+        }
+    }
+    
+    // Один прохід по файлу; стан розбору заголовка скидається, бо файл може читатися кілька разів
+    void readFile(const std::string& filename) {
+        format = Format::Unknown;
+        symmetry = Symmetry::General;
+        pattern = false;
+        sizeKnown = false;
+        countSeen = false;
+        restart = false;
+        
+        ChunkedFileReader reader(filename, options.chunkSize, options.backgroundRead);
+        std::string chunk;
+        std::string carry;
+        while (!restart && reader.next(chunk)) {
+            size_t start = 0;
+            size_t newline;
+            while (!restart && (newline = chunk.find('\n', start)) != std::string::npos) {
+                if (carry.empty()) {
+                    parseLine(chunk.data() + start, chunk.data() + newline);
+                } else {
+                    carry.append(chunk, start, newline - start);
+                    parseLine(carry.data(), carry.data() + carry.size());
+                    carry.clear();
+                }
+                start = newline + 1;
+            }
+            carry.append(chunk, start, std::string::npos);
+        }
+        if (!restart && !carry.empty()) parseLine(carry.data(), carry.data() + carry.size());
+        if (!sizeKnown) throw std::runtime_error("Invalid file format");
+    }
+    
+public:
+    explicit SparseMatrixLoader(const SparseLoadOptions& opts = SparseLoadOptions(), const T& defVal = T())
+        : options(opts), defaultValue(defVal) {}
+    
+    CSRSparseMatrix<T> load(const std::string& filename) {
+        readFile(filename);
+        if (restart) readFile(filename);
+        
+        size_t blockRows = lastRow - firstRow;
+        if (pass == Pass::Count) {
+            for (size_t i = 0; i < blockRows; ++i) rowPointers[i + 1] += rowPointers[i];
+            colIndices.assign(rowPointers.back(), 0);
+            values.assign(rowPointers.back(), defaultValue);
+            rowFill.assign(rowPointers.begin(), rowPointers.end() - 1);
+            pass = Pass::Fill;
+            readFile(filename);
+            std::vector<size_t>().swap(rowFill);
+            compactRows();
+            return CSRSparseMatrix<T>::fromArrays(blockRows, cols, std::move(rowPointers),
+                                                  std::move(colIndices), std::move(values), defaultValue);
+        }
+        
+        commitRows(blockRows);
+        while (committedRows < blockRows) {
+            rowPointers.push_back(values.size());
+            ++committedRows;
+        }
+        return CSRSparseMatrix<T>::fromArrays(blockRows, cols, std::move(rowPointers),
+                                              std::move(colIndices), std::move(values), defaultValue);
+    }
+    
+    static CSRSparseMatrix<T> loadFile(const std::string& filename,
+                                       const SparseLoadOptions& opts = SparseLoadOptions(),
+                                       const T& defVal = T()) {
+        SparseMatrixLoader<T> loader(opts, defVal);
+        return loader.load(filename);
+    }
+};
+
+#endif
\ No newline at end of file
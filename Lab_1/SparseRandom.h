@@ -0,0 +1,109 @@
+#ifndef SPARSERANDOM_H
+#define SPARSERANDOM_H
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+// Генератори псевдовипадкових чисел для розріджених структур.
+// SplitMix64 лише розгортає зерно в стан; основний генератор — xoshiro256**,
+// незалежні потоки отримуються з пари (зерно, номер потоку)
+class SplitMix64 {
+private:
+    uint64_t state;
+    
+public:
+    explicit SplitMix64(uint64_t seed) : state(seed) {}
+    
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+class Xoshiro256 {
+private:
+    uint64_t s[4];
+    
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+    
+public:
+    explicit Xoshiro256(uint64_t seed, uint64_t stream = 0) {
+        SplitMix64 mixer(seed ^ (0xD1B54A32D192ED03ULL * (stream + 1)));
+        for (uint64_t& word : s) word = mixer.next();
+    }
+    
+    uint64_t next() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+    
+    // Рівномірне ціле з [0, bound) без зсуву за модулем
+    uint64_t nextBelow(uint64_t bound) {
+        uint64_t threshold = (0 - bound) % bound;
+        while (true) {
+            uint64_t r = next();
+            if (r >= threshold) return r % bound;
+        }
+    }
+    
+    // Рівномірне дійсне з [0, 1) з 53 значущими бітами
+    double nextDouble() {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+// Рівно k різних чисел з [0, n) у порядку зростання, кожна k-підмножина рівноймовірна.
+// Для щільної вибірки — послідовний відбір за один прохід (алгоритм S Кнута),
+// для розрідженої — незалежні вибірки з дозабором на місце повторів
+inline void sampleWithoutReplacement(uint64_t n, size_t k, Xoshiro256& rng, std::vector<uint64_t>& out) {
+    out.clear();
+    if (k == 0) return;
+    if (k >= n) {
+        for (uint64_t i = 0; i < n; ++i) out.push_back(i);
+        return;
+    }
+    
+    if (k > n / 4) {
+        size_t needed = k;
+        for (uint64_t i = 0; i < n && needed > 0; ++i) {
+            if (rng.nextBelow(n - i) < needed) {
+                out.push_back(i);
+                --needed;
+            }
+        }
+        return;
+    }
+    
+    while (out.size() < k) {
+        size_t missing = k - out.size();
+        for (size_t i = 0; i < missing; ++i) out.push_back(rng.nextBelow(n));
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+}
+
+// Значення з generator(), відмінне від defaultValue: збережені елементи не можуть бути
+// значенням за замовчуванням, тому такі результати перегенеровуються
+template<typename T, typename Generator>
+T drawNonDefault(Generator&& generator, const T& defaultValue) {
+    for (int attempt = 0; attempt < 64; ++attempt) {
+        T value = generator();
+        if (!(value == defaultValue)) return value;
+    }
+    throw std::runtime_error("Value generator keeps returning the default value");
+}
+
+#endif
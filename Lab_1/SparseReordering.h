@@ -0,0 +1,328 @@
+#ifndef SPARSEREORDERING_H
+#define SPARSEREORDERING_H
+
+#include "SparseMatrix.h"
+#include <vector>
+#include <set>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+
+// Перестановки рядків і стовпців квадратної CSR-матриці для кращої локальності SpMV.
+// Перестановка perm задається як perm[новий індекс] = старий індекс і застосовується
+// симетрично: B[i][j] = A[perm[i]][perm[j]], тож Ax = b переходить у B(Px) = Pb
+struct MatrixProfile {
+    size_t bandwidth = 0;   // max |i - j| серед збережених елементів
+    size_t profile = 0;     // сума по рядках відстаней від діагоналі до найлівішого елемента
+};
+
+struct ReorderingReport {
+    MatrixProfile before;
+    MatrixProfile after;
+};
+
+template<typename T>
+MatrixProfile computeProfile(const CSRSparseMatrix<T>& matrix) {
+    const std::vector<size_t>& rowPointers = matrix.getRowPointers();
+    const std::vector<size_t>& colIndices = matrix.getColIndices();
+    
+    MatrixProfile result;
+    for (size_t i = 0; i < matrix.getRows(); ++i) {
+        size_t leftmost = i;
+        for (size_t j = rowPointers[i]; j < rowPointers[i + 1]; ++j) {
+            size_t col = colIndices[j];
+            result.bandwidth = std::max(result.bandwidth, col > i ? col - i : i - col);
+            leftmost = std::min(leftmost, col);
+        }
+        result.profile += i - leftmost;
+    }
+    return result;
+}
+
+inline std::vector<size_t> inversePermutation(const std::vector<size_t>& perm) {
+    std::vector<size_t> inverse(perm.size(), perm.size());
+    for (size_t i = 0; i < perm.size(); ++i) {
+        if (perm[i] >= perm.size() || inverse[perm[i]] != perm.size()) {
+            throw std::invalid_argument("Not a permutation");
+        }
+        inverse[perm[i]] = i;
+    }
+    return inverse;
+}
+
+// Граф структури A + A^T без діагоналі: списки сусідів відсортовані й без повторів
+template<typename T>
+std::vector<std::vector<size_t>> symmetricAdjacency(const CSRSparseMatrix<T>& matrix) {
+    if (matrix.getRows() != matrix.getCols()) {
+        throw std::invalid_argument("Reordering requires a square matrix");
+    }
+    
+    const std::vector<size_t>& rowPointers = matrix.getRowPointers();
+    const std::vector<size_t>& colIndices = matrix.getColIndices();
+    size_t n = matrix.getRows();
+    
+    std::vector<std::vector<size_t>> adjacency(n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = rowPointers[i]; j < rowPointers[i + 1]; ++j) {
+            size_t col = colIndices[j];
+            if (col == i) continue;
+            adjacency[i].push_back(col);
+            adjacency[col].push_back(i);
+        }
+    }
+    for (auto& neighbors : adjacency) {
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+    }
+    return adjacency;
+}
+
+// Обернений Катхілл-Макі: обхід у ширину від псевдопериферійної вершини кожної компоненти,
+// сусіди додаються в порядку зростання степеня, отриманий порядок розвертається.
+// Стискає ненульові елементи до смуги біля діагоналі
+template<typename T>
+std::vector<size_t> reverseCuthillMcKee(const CSRSparseMatrix<T>& matrix) {
+    std::vector<std::vector<size_t>> adjacency = symmetricAdjacency(matrix);
+    size_t n = adjacency.size();
+    const size_t unvisited = std::numeric_limits<size_t>::max();
+    
+    std::vector<size_t> order;
+    order.reserve(n);
+    std::vector<char> placed(n, 0);
+    std::vector<size_t> level(n, unvisited);
+    std::vector<size_t> frontier;
+    
+    // Рівні BFS від start у межах ще не розміщеної компоненти; повертає вершину
+    // найменшого степеня на останньому рівні та ексцентриситет start
+    auto farthest = [&](size_t start, size_t& eccentricity) {
+        frontier.assign(1, start);
+        level[start] = 0;
+        size_t best = start;
+        for (size_t head = 0; head < frontier.size(); ++head) {
+            size_t v = frontier[head];
+            if (level[v] > level[best]
+                || (level[v] == level[best] && adjacency[v].size() < adjacency[best].size())) {
+                best = v;
+            }
+            for (size_t u : adjacency[v]) {
+                if (level[u] == unvisited && !placed[u]) {
+                    level[u] = level[v] + 1;
+                    frontier.push_back(u);
+                }
+            }
+        }
+        eccentricity = level[best];
+        for (size_t v : frontier) level[v] = unvisited;
+        return best;
+    };
+    
+    std::vector<size_t> byDegree(n);
+    for (size_t i = 0; i < n; ++i) byDegree[i] = i;
+    std::stable_sort(byDegree.begin(), byDegree.end(),
+        [&](size_t a, size_t b) { return adjacency[a].size() < adjacency[b].size(); });
+    
+    for (size_t seed : byDegree) {
+        if (placed[seed]) continue;
+        
+        // Пошук псевдопериферійної вершини за Джорджем-Лю
+        size_t start = seed, eccentricity = 0;
+        size_t candidate = farthest(start, eccentricity);
+        while (true) {
+            size_t nextEccentricity = 0;
+            size_t next = farthest(candidate, nextEccentricity);
+            if (nextEccentricity <= eccentricity) break;
+            start = candidate;
+            candidate = next;
+            eccentricity = nextEccentricity;
+        }
+        
+        size_t head = order.size();
+        order.push_back(start);
+        placed[start] = 1;
+        for (; head < order.size(); ++head) {
+            size_t v = order[head];
+            size_t first = order.size();
+            for (size_t u : adjacency[v]) {
+                if (!placed[u]) {
+                    placed[u] = 1;
+                    order.push_back(u);
+                }
+            }
+            std::stable_sort(order.begin() + first, order.end(),
+                [&](size_t a, size_t b) { return adjacency[a].size() < adjacency[b].size(); });
+        }
+    }
+    
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+// Наближений мінімальний степінь на фактор-графі: виключена вершина стає елементом,
+// що поглинає сусідні елементи, а степінь сусідів оцінюється зверху як в AMD:
+// |A_i| + |L_p| + сума |L_e \ L_p| по інших елементах. Без супервершин і агресивного
+// поглинання, тому повільніший за оригінальний AMD, але зменшує заповнення так само
+template<typename T>
+std::vector<size_t> approximateMinimumDegree(const CSRSparseMatrix<T>& matrix) {
+    std::vector<std::vector<size_t>> variables = symmetricAdjacency(matrix);
+    size_t n = variables.size();
+    
+    std::vector<std::vector<size_t>> elements(n);   // елементи, суміжні зі змінною
+    std::vector<std::vector<size_t>> members(n);    // змінні живого елемента
+    std::vector<char> eliminated(n, 0), alive(n, 0);
+    std::vector<size_t> degree(n), mark(n, 0), weight(n, 0), weightMark(n, 0);
+    size_t stamp = 0;
+    
+    std::set<std::pair<size_t, size_t>> queue;
+    for (size_t i = 0; i < n; ++i) {
+        degree[i] = variables[i].size();
+        queue.emplace(degree[i], i);
+    }
+    
+    std::vector<size_t> order;
+    order.reserve(n);
+    std::vector<size_t> pivotMembers;
+    
+    for (size_t k = 0; k < n; ++k) {
+        size_t p = queue.begin()->second;
+        queue.erase(queue.begin());
+        order.push_back(p);
+        eliminated[p] = 1;
+        
+        // L_p = A_p ∪ L_e по всіх e з E_p; елементи E_p поглинаються
+        ++stamp;
+        mark[p] = stamp;
+        pivotMembers.clear();
+        for (size_t v : variables[p]) {
+            if (!eliminated[v] && mark[v] != stamp) {
+                mark[v] = stamp;
+                pivotMembers.push_back(v);
+            }
+        }
+        for (size_t e : elements[p]) {
+            if (!alive[e]) continue;
+            for (size_t v : members[e]) {
+                if (!eliminated[v] && mark[v] != stamp) {
+                    mark[v] = stamp;
+                    pivotMembers.push_back(v);
+                }
+            }
+            alive[e] = 0;
+            std::vector<size_t>().swap(members[e]);
+        }
+        members[p] = pivotMembers;
+        alive[p] = 1;
+        std::vector<size_t>().swap(variables[p]);
+        std::vector<size_t>().swap(elements[p]);
+        
+        // weight[e] = |L_e \ L_p| для елементів, що перетинаються з L_p
+        for (size_t i : pivotMembers) {
+            for (size_t e : elements[i]) {
+                if (!alive[e]) continue;
+                if (weightMark[e] != stamp) {
+                    weightMark[e] = stamp;
+                    weight[e] = members[e].size();
+                }
+                --weight[e];
+            }
+        }
+        
+        for (size_t i : pivotMembers) {
+            std::vector<size_t>& adjacent = variables[i];
+            adjacent.erase(std::remove_if(adjacent.begin(), adjacent.end(),
+                [&](size_t v) { return eliminated[v] || mark[v] == stamp; }), adjacent.end());
+            std::vector<size_t>& adjacentElements = elements[i];
+            adjacentElements.erase(std::remove_if(adjacentElements.begin(), adjacentElements.end(),
+                [&](size_t e) { return !alive[e]; }), adjacentElements.end());
+            
+            size_t estimate = adjacent.size() + pivotMembers.size() - 1;
+            for (size_t e : adjacentElements) {
+                estimate += (weightMark[e] == stamp) ? weight[e] : members[e].size();
+            }
+            adjacentElements.push_back(p);
+            estimate = std::min(estimate, n - k - 1);
+            
+            queue.erase(std::make_pair(degree[i], i));
+            degree[i] = estimate;
+            queue.emplace(degree[i], i);
+        }
+    }
+    
+    return order;
+}
+
+// B[i][j] = A[perm[i]][perm[j]]; рядки результату відсортовані за стовпцями
+template<typename T>
+CSRSparseMatrix<T> permuteMatrix(const CSRSparseMatrix<T>& matrix, const std::vector<size_t>& perm) {
+    if (matrix.getRows() != matrix.getCols() || perm.size() != matrix.getRows()) {
+        throw std::invalid_argument("Permutation size must match a square matrix");
+    }
+    
+    const std::vector<size_t>& rowPointers = matrix.getRowPointers();
+    const std::vector<size_t>& colIndices = matrix.getColIndices();
+    const std::vector<T>& values = matrix.getValues();
+    std::vector<size_t> inverse = inversePermutation(perm);
+    size_t n = perm.size();
+    
+    std::vector<size_t> newRowPointers(n + 1, 0);
+    std::vector<size_t> newCols(values.size());
+    std::vector<T> newValues(values.size());
+    std::vector<std::pair<size_t, T>> row;
+    
+    for (size_t i = 0; i < n; ++i) {
+        size_t old = perm[i];
+        row.clear();
+        for (size_t j = rowPointers[old]; j < rowPointers[old + 1]; ++j) {
+            row.emplace_back(inverse[colIndices[j]], values[j]);
+        }
+        std::sort(row.begin(), row.end(),
+            [](const std::pair<size_t, T>& a, const std::pair<size_t, T>& b) { return a.first < b.first; });
+        
+        size_t pos = newRowPointers[i];
+        for (const auto& entry : row) {
+            newCols[pos] = entry.first;
+            newValues[pos] = entry.second;
+            ++pos;
+        }
+        newRowPointers[i + 1] = pos;
+    }
+    
+    return CSRSparseMatrix<T>::fromArrays(n, n, std::move(newRowPointers), std::move(newCols),
+                                          std::move(newValues), matrix.getDefaultValue());
+}
+
+// Вектор у новій нумерації: result[i] = vec[perm[i]]
+template<typename T>
+std::vector<T> permuteVector(const std::vector<T>& vec, const std::vector<size_t>& perm) {
+    if (vec.size() != perm.size()) {
+        throw std::invalid_argument("Permutation size must match vector size");
+    }
+    std::vector<T> result(vec.size());
+    for (size_t i = 0; i < perm.size(); ++i) {
+        result[i] = vec[perm[i]];
+    }
+    return result;
+}
+
+// Повернення до старої нумерації: result[perm[i]] = vec[i]
+template<typename T>
+std::vector<T> unpermuteVector(const std::vector<T>& vec, const std::vector<size_t>& perm) {
+    if (vec.size() != perm.size()) {
+        throw std::invalid_argument("Permutation size must match vector size");
+    }
+    std::vector<T> result(vec.size());
+    for (size_t i = 0; i < perm.size(); ++i) {
+        result[perm[i]] = vec[i];
+    }
+    return result;
+}
+
+template<typename T>
+ReorderingReport compareOrdering(const CSRSparseMatrix<T>& original, const CSRSparseMatrix<T>& permuted) {
+    ReorderingReport report;
+    report.before = computeProfile(original);
+    report.after = computeProfile(permuted);
+    return report;
+}
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <algorithm>
+
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable available;
+    bool stopping = false;
+    
+    // Пул, якому належить поточний потік (nullptr поза робочими потоками)
+    static ThreadPool*& currentPool() {
+        thread_local ThreadPool* pool = nullptr;
+        return pool;
+    }
+    
+    void workerLoop() {
+        currentPool() = this;
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+    
+public:
+    explicit ThreadPool(size_t threadCount = std::max(1u, std::thread::hardware_concurrency())) {
+        for (size_t i = 0; i < threadCount; ++i) {
+            workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        available.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+    
+    size_t size() const {
+        return workers.size();
+    }
+    
+    // Виконує body(0..count-1) на потоках пулу і чекає завершення всіх задач.
+    // Перший виняток із задач перекидається у викликаючий потік. Виклик із задачі цього ж
+    // пулу виконується послідовно на місці: робочий потік, що чекає вкладених задач,
+    // не бере нових, і коли так чекають усі потоки, черга вже не виконується
+    void parallelFor(size_t count, const std::function<void(size_t)>& body) {
+        if (count == 0) return;
+        if (count == 1 || workers.empty() || currentPool() == this) {
+            for (size_t i = 0; i < count; ++i) body(i);
+            return;
+        }
+        
+        std::mutex doneMutex;
+        std::condition_variable done;
+        size_t remaining = count;
+        std::exception_ptr error;
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; i < count; ++i) {
+                tasks.push([&, i]() {
+                    std::exception_ptr taskError;
+                    try {
+                        body(i);
+                    } catch (...) {
+                        taskError = std::current_exception();
+                    }
+                    std::lock_guard<std::mutex> doneLock(doneMutex);
+                    if (taskError && !error) error = taskError;
+                    if (--remaining == 0) done.notify_one();
+                });
+            }
+        }
+        available.notify_all();
+        
+        std::unique_lock<std::mutex> lock(doneMutex);
+        done.wait(lock, [&]() { return remaining == 0; });
+        if (error) std::rethrow_exception(error);
+    }
+    
+    static ThreadPool& shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+};
+
+#endif
\ No newline at end of file
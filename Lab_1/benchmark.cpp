@@ -0,0 +1,439 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <functional>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "SparseList.h"
+#include "FlatSparseList.h"
+#include "SparseMatrix.h"
+#include "CompressedCSRMatrix.h"
+#include "SparseGenerators.h"
+#include "SparseRandom.h"
+#include "ThreadPool.h"
+#include "MathFunction.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+// Лічильник викликів глобального operator new: у сталому режимі операції *Into
+// і multiplyVector(in, out) мають давати нуль виділень на операцію
+atomic<size_t> allocationCount(0);
+
+// Замінені оператори не вбудовуються: інакше GCC бачить free на вказівнику з operator new
+// і видає -Wmismatched-new-delete. Форми [] замінено явно, тож усі виділення рахуються
+// однією парою malloc/free; вирівняні (align_val_t) лишаються бібліотечними й не рахуються
+#if defined(__GNUC__)
+#define BENCHMARK_NOINLINE __attribute__((noinline))
+#else
+#define BENCHMARK_NOINLINE
+#endif
+
+BENCHMARK_NOINLINE void* operator new(size_t size) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+BENCHMARK_NOINLINE void operator delete(void* p) noexcept {
+    free(p);
+}
+
+BENCHMARK_NOINLINE void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+BENCHMARK_NOINLINE void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+BENCHMARK_NOINLINE void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+BENCHMARK_NOINLINE void operator delete[](void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+// Результати вимірюваних читань зберігаються сюди, щоб компілятор не викинув цикли
+volatile double benchmarkSink = 0.0;
+
+// Пікова резидентна пам'ять процесу в кілобайтах; значення лише зростає,
+// тому для кожного випадку це максимум з початку запуску
+size_t peakRssKb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize / 1024;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss) / 1024;
+#else
+    return static_cast<size_t>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+struct BenchmarkConfig {
+    double minSeconds = 0.2;
+    bool quick = false;
+    string outputFile;
+};
+
+struct BenchmarkResult {
+    string operation;
+    string backend;
+    size_t rows = 0, cols = 0;
+    double density = 0.0;
+    size_t nonZeros = 0;
+    size_t iterations = 0;
+    double nsPerOp = 0.0;
+    double nnzPerSecond = -1.0;   // від'ємне значення — метрика не має сенсу для операції
+    double gflops = -1.0;
+    double allocationsPerOp = 0.0;
+    size_t peakRss = 0;
+};
+
+// Повторює op, подвоюючи кількість повторів, доки сумарний час не перевищить minSeconds.
+// Перший виклик — розігрів і до результату не входить
+double secondsPerOp(const function<void()>& op, double minSeconds, size_t& iterations, double& allocations) {
+    op();
+    size_t reps = 1;
+    while (true) {
+        size_t allocationsBefore = allocationCount.load(memory_order_relaxed);
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < reps; ++i) op();
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (elapsed >= minSeconds || reps >= (size_t(1) << 30)) {
+            iterations = reps;
+            allocations = static_cast<double>(allocationCount.load(memory_order_relaxed) - allocationsBefore)
+                        / static_cast<double>(reps);
+            return elapsed / static_cast<double>(reps);
+        }
+        reps *= 2;
+    }
+}
+
+class BenchmarkRunner {
+private:
+    BenchmarkConfig config;
+    vector<BenchmarkResult> results;
+    
+public:
+    explicit BenchmarkRunner(const BenchmarkConfig& cfg) : config(cfg) {}
+    
+    // Одна операція: opsPerCall — скільки елементарних операцій робить один виклик op
+    // (для пакетних get/set), work — оброблені ненульові елементи, flops — операції з плаваючою точкою
+    void run(const string& operation, const string& backend, size_t rows, size_t cols, double density,
+             size_t nonZeros, const function<void()>& op,
+             size_t opsPerCall = 1, double work = -1.0, double flops = -1.0) {
+        BenchmarkResult result;
+        result.operation = operation;
+        result.backend = backend;
+        result.rows = rows;
+        result.cols = cols;
+        result.density = density;
+        result.nonZeros = nonZeros;
+        
+        double seconds = secondsPerOp(op, config.minSeconds, result.iterations, result.allocationsPerOp);
+        result.nsPerOp = seconds * 1e9 / static_cast<double>(opsPerCall);
+        result.allocationsPerOp /= static_cast<double>(opsPerCall);
+        if (work >= 0.0) result.nnzPerSecond = work / seconds;
+        if (flops >= 0.0) result.gflops = flops / seconds * 1e-9;
+        result.peakRss = peakRssKb();
+        
+        cerr << setw(16) << left << operation << setw(16) << backend << setw(8) << right << rows
+             << " x " << setw(8) << left << cols << " nnz=" << setw(10) << nonZeros
+             << fixed << setprecision(1) << setw(14) << right << result.nsPerOp << " ns/op"
+             << setprecision(2) << setw(10) << result.allocationsPerOp << " allocs/op\n";
+        cerr.unsetf(ios::fixed);
+        results.push_back(result);
+    }
+    
+    string toJson() const {
+        ostringstream out;
+        out << setprecision(6);
+        auto metric = [&](double value) -> string {
+            if (value < 0.0) return "null";
+            ostringstream v;
+            v << setprecision(6) << value;
+            return v.str();
+        };
+        
+        out << "{\n  \"benchmark\": \"Lab_1\",\n  \"threads\": " << ThreadPool::shared().size()
+            << ",\n  \"quick\": " << (config.quick ? "true" : "false") << ",\n  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchmarkResult& r = results[i];
+            out << "    {\"operation\": \"" << r.operation << "\", \"backend\": \"" << r.backend
+                << "\", \"rows\": " << r.rows << ", \"cols\": " << r.cols
+                << ", \"density\": " << r.density << ", \"nnz\": " << r.nonZeros
+                << ", \"iterations\": " << r.iterations << ", \"ns_per_op\": " << r.nsPerOp
+                << ", \"nnz_per_s\": " << metric(r.nnzPerSecond) << ", \"gflops\": " << metric(r.gflops)
+                << ", \"allocs_per_op\": " << r.allocationsPerOp << ", \"peak_rss_kb\": " << r.peakRss << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+        return out.str();
+    }
+};
+
+// Кількість множень у добутку A * B: кожен a_ik множиться на весь рядок k матриці B
+double multiplyFlops(const CSRSparseMatrix<double>& a, const CSRSparseMatrix<double>& b) {
+    const vector<size_t>& bRows = b.getRowPointers();
+    double products = 0.0;
+    for (size_t k : a.getColIndices()) {
+        products += static_cast<double>(bRows[k + 1] - bRows[k]);
+    }
+    return 2.0 * products;
+}
+
+void benchmarkLists(BenchmarkRunner& runner, const BenchmarkConfig& config) {
+    struct ListCase { size_t size; double density; };
+    vector<ListCase> cases = config.quick
+        ? vector<ListCase>{ {10000, 0.01}, {10000, 0.1} }
+        : vector<ListCase>{ {10000, 0.01}, {100000, 0.01}, {100000, 0.1}, {1000000, 0.01} };
+    const size_t batch = 1024;
+    
+    for (const ListCase& c : cases) {
+        Xoshiro256 rng(c.size);
+        vector<size_t> positions(batch);
+        for (size_t& p : positions) p = static_cast<size_t>(rng.nextBelow(c.size));
+        auto value = []() { return 1.0 + (rand() % 1000) / 100.0; };
+        
+        SparseList<double> mapList;
+        mapList.generateRandom(c.size, c.density, value, 42);
+        FlatSparseList<double> flatList;
+        flatList.generateRandom(c.size, c.density, value, 42);
+        size_t nnz = mapList.nonZeroCount();
+        
+        auto listCase = [&](ISparseContainer<double>& list, const string& backend) {
+            double sink = 0.0;
+            runner.run("get", backend, c.size, 1, c.density, nnz, [&]() {
+                for (size_t p : positions) sink += list.get(p);
+            }, batch);
+            runner.run("set", backend, c.size, 1, c.density, nnz, [&]() {
+                for (size_t p : positions) list.set(p, 7.5);
+            }, batch);
+            runner.run("findByValue", backend, c.size, 1, c.density, nnz, [&]() {
+                sink += list.findByValue(-1.0);
+            }, 1, static_cast<double>(nnz));
+            benchmarkSink = sink;
+        };
+        listCase(mapList, "SparseList");
+        listCase(flatList, "FlatSparseList");
+        
+        // Масові операції: перший виклик (розігрів) будує знімок збережених елементів
+        double sink = 0.0;
+        runner.run("reduce", "SparseList", c.size, 1, c.density, nnz, [&]() {
+            sink += mapList.reduce(0.0, [](double a, double b) { return a + b; });
+        }, 1, static_cast<double>(nnz));
+        runner.run("countIf", "SparseList", c.size, 1, c.density, nnz, [&]() {
+            sink += static_cast<double>(mapList.countIf([](double x) { return x > 5.0; }));
+        }, 1, static_cast<double>(nnz));
+        runner.run("transform", "SparseList", c.size, 1, c.density, nnz, [&]() {
+            sink += static_cast<double>(mapList.transform([](double x) { return 2.0 * x; }).nonZeroCount());
+        }, 1, static_cast<double>(nnz));
+        runner.run("filter", "SparseList", c.size, 1, c.density, nnz, [&]() {
+            sink += static_cast<double>(mapList.filter([](double x) { return x > 5.0; }).nonZeroCount());
+        }, 1, static_cast<double>(nnz));
+        runner.run("topK", "SparseList", c.size, 1, c.density, nnz, [&]() {
+            sink += mapList.topK(10).front().second;
+        }, 1, static_cast<double>(nnz));
+        benchmarkSink = sink;
+    }
+}
+
+void benchmarkMatrices(BenchmarkRunner& runner, const BenchmarkConfig& config) {
+    struct MatrixCase { size_t size; double density; };
+    vector<MatrixCase> cases = config.quick
+        ? vector<MatrixCase>{ {300, 0.05}, {1000, 0.01} }
+        : vector<MatrixCase>{ {300, 0.05}, {1000, 0.01}, {10000, 0.001}, {10000, 0.005},
+                              {100000, 0.0001}, {100000, 0.0005} };
+    const size_t batch = 1024;
+    const double mapMultiplyLimit = 1e8;    // потрійний цикл Map::multiply — n^3 звертань
+    const double productNnzLimit = 2e7;     // оцінка розміру добутку для CSR
+    
+    for (const MatrixCase& c : cases) {
+        size_t n = c.size;
+        size_t nnz = static_cast<size_t>(static_cast<double>(n) * static_cast<double>(n) * c.density);
+        
+        SparseGeneratorOptions options;
+        options.seed = n;
+        CSRSparseMatrix<double> csrA = SparseGenerator<double>(options).generateMatrix(n, n, nnz);
+        options.seed = n + 1;
+        CSRSparseMatrix<double> csrB = SparseGenerator<double>(options).generateMatrix(n, n, nnz);
+        MapSparseMatrix<double> mapA = csrA.toMap();
+        MapSparseMatrix<double> mapB = csrB.toMap();
+        
+        Xoshiro256 rng(n);
+        vector<pair<size_t, size_t>> positions(batch);
+        for (auto& p : positions) p = make_pair(rng.nextBelow(n), rng.nextBelow(n));
+        vector<double> x(n, 1.0), y;
+        for (size_t i = 0; i < n; ++i) x[i] = rng.nextDouble();
+        
+        double addWork = static_cast<double>(2 * nnz);
+        double mulFlops = multiplyFlops(csrA, csrB);
+        double productEstimate = static_cast<double>(nnz) * static_cast<double>(nnz) / static_cast<double>(n);
+        
+        auto matrixCase = [&](SparseMatrix<double>& a, const SparseMatrix<double>& b, const string& backend) {
+            double sink = 0.0;
+            runner.run("get", backend, n, n, c.density, nnz, [&]() {
+                for (const auto& p : positions) sink += a.get(p.first, p.second);
+            }, batch);
+            runner.run("set", backend, n, n, c.density, nnz, [&]() {
+                for (const auto& p : positions) a.set(p.first, p.second, 2.5);
+            }, batch);
+            runner.run("add", backend, n, n, c.density, nnz, [&]() {
+                unique_ptr<SparseMatrix<double>> sum(a.add(b));
+            }, 1, addWork, addWork / 2);
+            if ((backend == "Map" && static_cast<double>(n) * n * n <= mapMultiplyLimit)
+                || (backend == "CSR" && productEstimate <= productNnzLimit)) {
+                runner.run("multiply", backend, n, n, c.density, nnz, [&]() {
+                    unique_ptr<SparseMatrix<double>> product(a.multiply(b));
+                }, 1, static_cast<double>(2 * nnz), mulFlops);
+            }
+            runner.run("multiplyVector", backend, n, n, c.density, nnz, [&]() {
+                a.multiplyVector(x, y);
+            }, 1, static_cast<double>(nnz), 2.0 * static_cast<double>(nnz));
+            runner.run("transpose", backend, n, n, c.density, nnz, [&]() {
+                unique_ptr<SparseMatrix<double>> t(a.transpose());
+            }, 1, static_cast<double>(nnz));
+            benchmarkSink = sink;
+        };
+        // set змінює матрицю, тому кожен бекенд міряється на власній копії
+        CSRSparseMatrix<double> csrWork = csrA;
+        matrixCase(csrWork, csrB, "CSR");
+        
+        // Варіанти з результатом, що перевикористовується між викликами
+        CSRSparseMatrix<double> reused;
+        runner.run("addInto", "CSR", n, n, c.density, nnz, [&]() {
+            csrA.addInto(csrB, reused);
+        }, 1, addWork, addWork / 2);
+        if (productEstimate <= productNnzLimit) {
+            runner.run("multiplyInto", "CSR", n, n, c.density, nnz, [&]() {
+                csrA.multiplyInto(csrB, reused);
+            }, 1, static_cast<double>(2 * nnz), mulFlops);
+        }
+        runner.run("transposeInto", "CSR", n, n, c.density, nnz, [&]() {
+            csrA.transposeInto(reused);
+        }, 1, static_cast<double>(nnz));
+        
+        // Та сама матриця з 32-бітними і стиснутими індексами: SpMV обмежений пам'яттю
+        CSRSparseMatrix<double, uint32_t> csr32 = csrA.withIndexType<uint32_t>();
+        CompressedCSRMatrix<double> compressed(csrA);
+        runner.run("multiplyVector", "CSR32", n, n, c.density, nnz, [&]() {
+            csr32.multiplyVector(x, y);
+        }, 1, static_cast<double>(nnz), 2.0 * static_cast<double>(nnz));
+        runner.run("multiplyVector", "CompressedCSR", n, n, c.density, nnz, [&]() {
+            compressed.multiplyVector(x, y);
+        }, 1, static_cast<double>(nnz), 2.0 * static_cast<double>(nnz));
+        matrixCase(mapA, mapB, "Map");
+    }
+}
+
+void benchmarkFunctions(BenchmarkRunner& runner, const BenchmarkConfig& config) {
+    // Многочлен 3x^3 + 2x^2 - 5x + 1 і неспрощені похідні sin(x^2), дерево яких росте експоненційно
+    auto x = make_shared<Variable>();
+    auto polynomial = make_shared<Sum>(
+        make_shared<Sum>(make_shared<Product>(make_shared<Constant>(3.0), make_shared<Power>(x, 3.0)),
+                         make_shared<Product>(make_shared<Constant>(2.0), make_shared<Power>(x, 2.0))),
+        make_shared<Sum>(make_shared<Product>(make_shared<Constant>(-5.0), x), make_shared<Constant>(1.0)));
+    shared_ptr<MathExpression> derivative = make_shared<Sin>(make_shared<Power>(x, 2.0));
+    for (int i = 0; i < (config.quick ? 3 : 5); ++i) derivative = derivative->differentiate();
+    
+    struct FunctionCase { string name; shared_ptr<MathExpression> expression; };
+    vector<FunctionCase> cases = { {"evaluatePolynomial", polynomial},
+                                   {"evaluateDerivative", derivative} };
+    const size_t batch = 256;
+    
+    for (const FunctionCase& c : cases) {
+        MathFunction f(c.expression);
+        size_t instructions = f.getProgram().size();
+        double sink = 0.0;
+        runner.run(c.name, "Tree", instructions, 1, 1.0, 0, [&]() {
+            for (size_t i = 0; i < batch; ++i) sink += c.expression->evaluate(0.5 + 1e-3 * static_cast<double>(i));
+        }, batch);
+        runner.run(c.name, "Bytecode", instructions, 1, 1.0, 0, [&]() {
+            for (size_t i = 0; i < batch; ++i) sink += f.evaluate(0.5 + 1e-3 * static_cast<double>(i));
+        }, batch);
+        vector<double> xs(batch), ys(batch);
+        for (size_t i = 0; i < batch; ++i) xs[i] = 0.5 + 1e-3 * static_cast<double>(i);
+        runner.run(c.name, "BytecodeBatch", instructions, 1, 1.0, 0, [&]() {
+            f.evaluate(xs.data(), ys.data(), batch);
+            sink += ys[batch - 1];
+        }, batch);
+        benchmarkSink = sink;
+    }
+    
+    // Автоматичне диференціювання: 20 коефіцієнтів Тейлора і крок Ньютона за один прохід
+    MathFunction wave(make_shared<Sin>(make_shared<Power>(x, 2.0)));
+    size_t instructions = wave.getProgram().size();
+    double sink = 0.0;
+    runner.run("taylorSeries20", "TaylorMode", instructions, 1, 1.0, 0, [&]() {
+        sink += wave.taylorSeries(0.5, 20).back();
+    });
+    runner.run("evaluateWithDerivative", "Dual", instructions, 1, 1.0, 0, [&]() {
+        for (size_t i = 0; i < batch; ++i) {
+            double slope;
+            sink += wave.evaluateWithDerivative(0.5 + 1e-3 * static_cast<double>(i), slope) + slope;
+        }
+    }, batch);
+    benchmarkSink = sink;
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkConfig config;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--quick") {
+            config.quick = true;
+            config.minSeconds = 0.05;
+        } else if (arg == "--output" && i + 1 < argc) {
+            config.outputFile = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            config.minSeconds = atof(argv[++i]);
+        } else {
+            cerr << "Usage: " << argv[0] << " [--quick] [--min-time seconds] [--output file.json]\n";
+            return 1;
+        }
+    }
+    
+    try {
+        BenchmarkRunner runner(config);
+        benchmarkLists(runner, config);
+        benchmarkMatrices(runner, config);
+        benchmarkFunctions(runner, config);
+        
+        string json = runner.toJson();
+        if (config.outputFile.empty()) {
+            cout << json;
+        } else {
+            ofstream out(config.outputFile);
+            if (!out) throw runtime_error("Cannot open file for writing");
+            out << json;
+        }
+    } catch (const exception& e) {
+        cerr << "\nError: " << e.what() << "\n";
+        return 1;
+    }
+    
+    return 0;
+}
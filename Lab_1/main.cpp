@@ -5,6 +5,7 @@
 #include <type_traits>
 #include "ISparseContainer.h"
 #include "SparseList.h"
+#include "FlatSparseList.h"
 #include "SparseMatrix.h"
 #include "MathExpression.h"
 #include "MathFunction.h"
@@ -72,6 +73,10 @@ void demonstrateSparseStructures() {
     doubleList.generateRandom(50, 0.15, []() { return (rand() % 1000) / 100.0; });
     demonstrateContainerNumeric(doubleList, "Sparse List (double)");
     
+    FlatSparseList<int> flatList(100, 0);
+    flatList.generateRandom(100, 0.1, []() { return rand() % 20 + 1; });
+    demonstrateContainerNumeric(flatList, "Flat Sparse List (int)");
+    
     
     MapSparseMatrix<int> matrix1(10, 10, 0);
     matrix1.generateRandom(10, 10, 0.2, []() { return rand() % 10 + 1; });